@@ -0,0 +1,17 @@
+#!/bin/bash
+# Veliko globalnih spremenljivk (user-018): 3000 deklaracij in 40 krogov
+# pristevanja vsaki, skupaj 123k vrstic; imena ne smejo vsebovati stevk,
+# zato je indeks zapisan s crkami (spremenljivkaaaa, spremenljivkaaab, ...)
+awk 'function name(i,    s, k) {
+         s = ""
+         for (k = 0; k < 3; k++) {
+             s = substr("abcdefghijklmnopqrstuvwxyz", i % 26 + 1, 1) s
+             i = int(i / 26)
+         }
+         return "spremenljivka" s
+     }
+     BEGIN {
+         for (i = 0; i < 3000; i++) print "rezerviraj " name(i) " = 1;"
+         for (r = 0; r < 40; r++) for (i = 0; i < 3000; i++) print name(i) " = " name(i) " + 1"
+         print "izpisi(" name(0) ")"
+     }'
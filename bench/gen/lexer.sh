@@ -0,0 +1,17 @@
+#!/bin/bash
+# Velik program za lekser (user-001): ponovljen odsek z vsemi vrstami zetonov
+# Velikost v MB: LEXER_MB (privzeto 4)
+mb="${LEXER_MB:-4}"
+snippet='Kvadrat(2) + (1 + 2) * 3 - 4 / 5 % 6
+vsota == 1.5
+"niz z besedami" != nic
+o = { kljuc: 1, drugi: "vrednost" }
+o["kljuc"] >= o.kljuc
+'
+count=$(( mb * 1024 * 1024 / ${#snippet} ))
+echo 'rezerviraj vsota = 0;'
+echo 'rezerviraj nic = 0;'
+echo 'rezerviraj o = { kljuc: 1 };'
+for ((i = 0; i < count; i++)); do
+    printf '%s' "$snippet"
+done
@@ -0,0 +1,15 @@
+#!/bin/bash
+# Program z veliko zetoni za parser (user-002): gnezdeni izrazi, ce in zanke
+# Stevilo zetonov v milijonih: PARSER_MTOKENS (privzeto 2)
+mtokens="${PARSER_MTOKENS:-2}"
+# Odsek ima 89 zetonov
+snippet='ce (vsota < 1) { vsota = vsota + ((1 + 2) * (3 - 4)) / (5 + 6 * 7) } sicer { vsota = vsota - 1 }
+za (rezerviraj i = 0; i < 1; i = i + 1) { vsota = vsota + i * (2 + 3) % 4 }
+dokler (vsota > 10) { vsota = vsota - Koren(4) }
+'
+count=$(( mtokens * 1000000 / 89 ))
+echo 'rezerviraj vsota = 0;'
+for ((i = 0; i < count; i++)); do
+    printf '%s' "$snippet"
+done
+echo 'izpisi(vsota)'
@@ -0,0 +1,58 @@
+#!/bin/bash
+# Meritve hitrosti: najmanjsi cas CPU (user + sys) izmed N zagonov
+#
+#     bench/run.sh [-n N] [slo++] [nastavitve slo++ ...]
+#
+# Brez poti do slo++ se interpreter prevede z g++ -O2 v zacasno mapo.
+# Izvedejo se vsi bench/*.slo in programi, ki jih izpisejo bench/gen/*.sh
+# (velike vhodne datoteke za lekser in parser). Filter po imenu: BENCH=ime
+set -e
+shopt -s nullglob
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+runs=5
+if [ "$1" = "-n" ]; then
+    runs="$2"
+    shift 2
+fi
+
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+if [ -n "$1" ] && [ -x "$1" ]; then
+    slopp="$1"
+    shift
+else
+    slopp="$work/slo++"
+    g++ -std=c++17 -O2 -o "$slopp" "$root"/main.cpp "$root"/frontend/*.cpp "$root"/runtime/*.cpp
+fi
+
+# Najmanjsi cas CPU v sekundah za en program
+measure() {
+    local best=""
+    for ((i = 0; i < runs; i++)); do
+        local t
+        t=$( { TIMEFORMAT='%3U %3S'; time "$slopp" "$@" </dev/null >/dev/null 2>&1; } 2>&1 | awk '{ printf "%.3f", $1 + $2 }')
+        if [ -z "$best" ] || awk -v a="$t" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+            best="$t"
+        fi
+    done
+    echo "$best"
+}
+
+printf '%-20s %s\n' "program" "cas [s] ($runs zagonov, slo++ $*)"
+for file in "$root"/bench/*.slo; do
+    name="$(basename "$file" .slo)"
+    if [ -n "$BENCH" ] && [ "$name" != "$BENCH" ]; then
+        continue
+    fi
+    printf '%-20s %s\n' "$name" "$(measure "$@" "$file")"
+done
+for generator in "$root"/bench/gen/*.sh; do
+    name="$(basename "$generator" .sh)"
+    if [ -n "$BENCH" ] && [ "$name" != "$BENCH" ]; then
+        continue
+    fi
+    bash "$generator" > "$work/$name.slo"
+    printf '%-20s %s\n' "$name" "$(measure "$@" "$work/$name.slo")"
+done
@@ -39,8 +39,12 @@ std::string shift(std::string& str) {
 }
 
 
-Token token(std::string value, TokenType type) {
-    return {type, value};
+Token token(TokenType type, size_t offset, size_t length, Symbol symbol) {
+    return {type, offset, length, symbol};
+}
+
+std::string_view lexeme(std::string_view source, const Token& token) {
+    return source.substr(token.offset, token.length);
 }
 
 bool isBinaryOperator(char c) {
@@ -146,8 +150,16 @@ std::string tokenTypeToString(Token token) {
             return "OpenParen";
         case TokenType::CloseParen:
             return "CloseParen";
-        case TokenType::BinaryOperator:
-            return "BinaryOperator";
+        case TokenType::Plus:
+            return "Plus";
+        case TokenType::Minus:
+            return "Minus";
+        case TokenType::Star:
+            return "Star";
+        case TokenType::Slash:
+            return "Slash";
+        case TokenType::Percent:
+            return "Percent";
         case TokenType::Let:
             return "Let";
         case TokenType::Const:
@@ -207,8 +219,16 @@ std::string tokenTypeToString(TokenType token) {
             return "OpenParen";
         case TokenType::CloseParen:
             return "CloseParen";
-        case TokenType::BinaryOperator:
-            return "BinaryOperator";
+        case TokenType::Plus:
+            return "Plus";
+        case TokenType::Minus:
+            return "Minus";
+        case TokenType::Star:
+            return "Star";
+        case TokenType::Slash:
+            return "Slash";
+        case TokenType::Percent:
+            return "Percent";
         case TokenType::Let:
             return "Let";
         case TokenType::Const:
@@ -219,6 +239,10 @@ std::string tokenTypeToString(TokenType token) {
             return "If";
         case TokenType::Else:
             return "Else";
+        case TokenType::While:
+            return "While";
+        case TokenType::For:
+            return "For";
         case TokenType::EndOfFile:
             return "EndOfFile";
         case TokenType::Comma:
@@ -256,6 +280,34 @@ std::string tokenTypeToString(TokenType token) {
     }
 }
 
+std::string operatorToString(OperatorType oper) {
+    switch (oper) {
+        case OP_ADD:
+            return "+";
+        case OP_SUBTRACT:
+            return "-";
+        case OP_MULTIPLY:
+            return "*";
+        case OP_DIVIDE:
+            return "/";
+        case OP_MODULO:
+            return "%";
+        case OP_EQUALS:
+            return "==";
+        case OP_NOT_EQUALS:
+            return "!=";
+        case OP_LESS:
+            return "<";
+        case OP_GREATER:
+            return ">";
+        case OP_LESS_EQUALS:
+            return "<=";
+        case OP_GREATER_EQUALS:
+            return ">=";
+        default:
+            return "Unknown";
+    }
+}
 
 std::string ftos(float f) {
     std::ostringstream oss;
@@ -310,6 +362,8 @@ std::string Statement::getKindName() const {
             return "FunctionDeclaration";
         case NODE_NUMERICLITERAL:
             return "NumericLiteral";
+        case NODE_BOOLEANLITERAL:
+            return "BooleanLiteral";
         case NODE_IDENTIFIER:
             return "Identifier";
         case NODE_BINARYEXPRESSION:
@@ -322,6 +376,8 @@ std::string Statement::getKindName() const {
             return "ObjectLiteral";
         case NODE_IFEXPRESSION:
             return "IfExpression";
+        case NODE_LOOPSTATEMENT:
+            return "LoopStatement";
         case NODE_CALLEXPRESSION:
             return "CallExpression";
         case NODE_MEMBEREXPRESSION:
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -16,12 +17,15 @@
 #include <cmath>
 #include <random>
 
+#include "symbols.h"
+
 enum NodeType {
     // Statements
     NODE_PROGRAM,
     NODE_VARIABLEDECLARATION,
     NODE_FUNCTIONDECLARATION,
     NODE_IFEXPRESSION,
+    NODE_LOOPSTATEMENT,
 
     // Expressions
     NODE_ASSIGNMENTEXPRESSION,
@@ -33,6 +37,7 @@ enum NodeType {
     NODE_OBJECTLITERAL,
     NODE_NUMERICLITERAL,
     NODE_STRINGLITERAL,
+    NODE_BOOLEANLITERAL,
     NODE_IDENTIFIER,
     NODE_BINARYEXPRESSION,
 };
@@ -49,10 +54,16 @@ enum TokenType {
     Fn,                 // funkcija
     If,                 // ce
     Else,               // sicer
+    While,              // dokler
+    For,                // za
 
     // Grouping * Operators
     Quotation,          // ""
-    BinaryOperator,     // + - * / 
+    Plus,               // +
+    Minus,              // -
+    Star,               // *
+    Slash,              // /
+    Percent,            // %
     Equals,             // =
     Comma,              // ,
     Dot,                // .
@@ -74,15 +85,39 @@ enum TokenType {
     EndOfFile,          // EOF
 };
 
+enum OperatorType {
+    OP_NONE,
+
+    // Arithmetic
+    OP_ADD,             // +
+    OP_SUBTRACT,        // -
+    OP_MULTIPLY,        // *
+    OP_DIVIDE,          // /
+    OP_MODULO,          // %
+
+    // Comparison
+    OP_EQUALS,          // ==
+    OP_NOT_EQUALS,      // !=
+    OP_LESS,            // <
+    OP_GREATER,         // >
+    OP_LESS_EQUALS,     // <=
+    OP_GREATER_EQUALS,  // >=
+};
+
 struct Token {
     TokenType type;
-    std::string value = "";
+    // Zacetek in dolzina leksema v izvorni kodi
+    size_t offset = 0;
+    size_t length = 0;
+    // Simbol imena ali niza, NO_SYMBOL za ostale zetone
+    Symbol symbol = NO_SYMBOL;
 };
 
 std::string readFile(const std::string& filename);
 std::vector<std::string> split(const std::string& str);
 std::string shift(std::string& str);
-Token token(std::string value, TokenType type);
+Token token(TokenType type, size_t offset, size_t length, Symbol symbol = NO_SYMBOL);
+std::string_view lexeme(std::string_view source, const Token& token);
 bool isBinaryOperator(char c);
 
 char toUpperCase(char c);
@@ -97,6 +132,7 @@ bool isNumber(std::string& str);
 bool isSkippable(char c);
 std::string tokenTypeToString(Token token);
 std::string tokenTypeToString(TokenType token);
+std::string operatorToString(OperatorType oper);
 std::string ftos(float f);
 
 template <typename T> T shiftVector(std::vector<T>& vec);
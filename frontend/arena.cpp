@@ -0,0 +1,43 @@
+#include "arena.h"
+
+AstArena::AstArena(size_t blockSize) : blockSize(blockSize) {}
+
+/**
+ * Run the destructors of all objects in reverse order of creation
+ * and release every block in one step.
+ */
+AstArena::~AstArena() {
+    for (auto it = this->destructors.rbegin(); it != this->destructors.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    for (char* block : this->blocks) {
+        ::operator delete(block);
+    }
+}
+
+/**
+ * Bump-allocate memory from the current block.
+ *
+ * @param size The size of the object in bytes.
+ * @param alignment The required alignment of the object.
+ * @return Pointer to uninitialized memory inside the arena.
+ */
+void* AstArena::allocate(size_t size, size_t alignment) {
+    uintptr_t current = reinterpret_cast<uintptr_t>(this->cursor);
+    uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    if (this->cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(this->limit)) {
+        // Objects larger than a block get a block of their own
+        size_t capacity = std::max(this->blockSize, size + alignment);
+        char* block = static_cast<char*>(::operator new(capacity));
+        this->blocks.push_back(block);
+        this->cursor = block;
+        this->limit = block + capacity;
+
+        current = reinterpret_cast<uintptr_t>(this->cursor);
+        aligned = (current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    this->cursor = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
@@ -0,0 +1,53 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "Functions.h"
+
+#include <memory>
+#include <new>
+
+// Arena za vozlisca AST
+// Vozlisca so zaporedno alocirana v velikih blokih
+// in so vsa sproscena naenkrat, ko se arena unici
+
+class AstArena {
+  private:
+    // Velikost posameznega bloka
+    size_t blockSize;
+
+    // Alocirani bloki
+    std::vector<char*> blocks = {};
+
+    // Prosti prostor v trenutnem bloku
+    char* cursor = nullptr;
+    char* limit = nullptr;
+
+    // Destruktorji objektov, ki jih je treba poklicati ob sproscanju
+    struct Destructor {
+        void (*destroy)(void*);
+        void* object;
+    };
+    std::vector<Destructor> destructors = {};
+
+    // Zagotovi prostor za objekt dolocene velikosti in poravnave
+    void* allocate(size_t size, size_t alignment);
+
+  public:
+    AstArena(size_t blockSize = 64 * 1024);
+    ~AstArena();
+
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    // Ustvari objekt v areni
+    template <typename T, typename... Args> T* make(Args&&... args) {
+        void* memory = this->allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            this->destructors.push_back({[](void* o) { static_cast<T*>(o)->~T(); }, object});
+        }
+        return object;
+    }
+};
+
+#endif
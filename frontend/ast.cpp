@@ -18,9 +18,18 @@ VariableDeclaration::VariableDeclaration(Expression* val, bool c, std::string id
   expressionValue = val;
   constant = c;
   identifier = id;
+  symbol = symbols().intern(id);
 }
 
-VariableDeclaration::VariableDeclaration(std::string id, bool c) : constant(c), identifier(id) { 
+VariableDeclaration::VariableDeclaration(Expression* val, bool c, std::string id, Symbol s) {
+  kind = NodeType::NODE_VARIABLEDECLARATION;
+  expressionValue = val;
+  constant = c;
+  identifier = id;
+  symbol = s;
+}
+
+VariableDeclaration::VariableDeclaration(std::string id, bool c) : constant(c), identifier(id), symbol(symbols().intern(id)) { 
   kind = NodeType::NODE_VARIABLEDECLARATION; 
   constant = c;
 }
@@ -51,6 +60,18 @@ FunctionDeclaration::FunctionDeclaration(std::vector<std::string>& p, std::strin
   parameters = p;
   name = n;
   body = b;
+  for (const auto& param : p) {
+    parameterSymbols.push_back(symbols().intern(param));
+  }
+  nameSymbol = symbols().intern(n);
+}
+FunctionDeclaration::FunctionDeclaration(std::vector<std::string>& p, std::vector<Symbol>& ps, std::string& n, Symbol ns, std::vector<Statement*>& b) {
+  kind = NodeType::NODE_FUNCTIONDECLARATION;
+  parameters = p;
+  parameterSymbols = ps;
+  name = n;
+  nameSymbol = ns;
+  body = b;
 }
 FunctionDeclaration::~FunctionDeclaration() = default;
 std::vector<std::string> parameters = {};
@@ -115,7 +136,22 @@ void IfStatement::toString() {
   std::cout << "}\n";
 }
 
-Iden::Iden(std::string val) : value(val) { kind = NodeType::NODE_IDENTIFIER; }
+LoopStatement::LoopStatement(Expression* t, std::vector<Statement*> b) {
+  kind = NODE_LOOPSTATEMENT;
+  test = t;
+  body = b;
+}
+LoopStatement::LoopStatement(Statement* i, Expression* t, Expression* u, std::vector<Statement*> b) {
+  kind = NODE_LOOPSTATEMENT;
+  init = i;
+  test = t;
+  update = u;
+  body = b;
+}
+
+Iden::Iden(std::string val) : Iden(val, symbols().intern(val)) {}
+
+Iden::Iden(std::string val, Symbol s) : value(val), symbol(s) { kind = NodeType::NODE_IDENTIFIER; }
 
 void Iden::toString() {
   std::cout << "{\n";
@@ -124,7 +160,7 @@ void Iden::toString() {
   std::cout << "}";
 }
 
-NumericLiteral::NumericLiteral(float val) : value(val) {
+NumericLiteral::NumericLiteral(double val) : value(val) {
     kind = NodeType::NODE_NUMERICLITERAL;
 }
 
@@ -135,7 +171,11 @@ void NumericLiteral::toString() {
     std::cout << "}";
 }
 
-StringLiteral::StringLiteral(std::string val) : value(val) { kind = NodeType::NODE_STRINGLITERAL; }
+StringLiteral::StringLiteral(std::string val) : StringLiteral(val, symbols().intern(val)) {}
+
+StringLiteral::StringLiteral(std::string val, Symbol s) : value(val), symbol(s) { kind = NodeType::NODE_STRINGLITERAL; }
+
+BooleanLiteral::BooleanLiteral(bool val) : value(val) { kind = NodeType::NODE_BOOLEANLITERAL; }
 
 AssignmentExpression::AssignmentExpression() {
   kind = NodeType::NODE_ASSIGNMENTEXPRESSION;
@@ -146,7 +186,7 @@ AssignmentExpression::AssignmentExpression(Expression* a, Expression* v) {
   value = v;
 }
 
-BinaryExpression::BinaryExpression(Expression* l, Expression* r, const std::string& op)
+BinaryExpression::BinaryExpression(Expression* l, Expression* r, OperatorType op)
     : left(l), right(r), oper(op) {
     kind = NodeType::NODE_BINARYEXPRESSION;
 }
@@ -163,7 +203,7 @@ void BinaryExpression::toString() {
         dynamic_cast<NumericLiteral*>(this->left)->toString();
     }
 
-    std::cout << "  oper: \"" << this->oper << "\"\n";
+    std::cout << "  oper: \"" << operatorToString(this->oper) << "\"\n";
     std::cout << "}";
 }
 
@@ -244,12 +284,21 @@ Property::Property() {
 Property::Property(NodeType k, std::string ke) {
     this->kind = k;
     this->key = ke;
+    this->symbol = symbols().intern(ke);
     this->value = nullptr;
 }
 
 Property::Property(NodeType k, std::string ke, Expression* val) {
     this->kind = k;
     this->key = ke;
+    this->symbol = symbols().intern(ke);
+    this->value = val;
+}
+
+Property::Property(NodeType k, std::string ke, Symbol s, Expression* val) {
+    this->kind = k;
+    this->key = ke;
+    this->symbol = s;
     this->value = val;
 }
 
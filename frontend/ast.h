@@ -2,6 +2,24 @@
 #define AST_H
 
 #include "lexer.h"
+#include "arena.h"
+
+// Prevedena koda navideznega stroja (runtime/bytecode.h)
+struct Chunk;
+
+// Prototip funkcije, skupen vsem njenim zaprtjem (runtime/environment.h)
+class FunctionPrototype;
+
+// Telo funkcije in zanka, prevedena v zaprtja C++ (runtime/closures.h)
+struct ClosureBody;
+struct ClosureLoop;
+
+// Strojna koda stevilske funkcije (runtime/jit.h)
+struct JitCode;
+
+// Imenovana spremenljivka in oblika objekta, na kateri kazejo predpomnilniki vozlisc
+struct Binding;
+class Shape;
 
 class Expression : public Statement {
   
@@ -17,6 +35,9 @@ public:
     std::vector<Statement*>& getBody();
 
     std::vector<Statement*> body;
+
+    // Arena, ki hrani vsa vozlisca tega programa
+    std::shared_ptr<AstArena> arena;
 };
 
 class VariableDeclaration : public Statement {
@@ -24,6 +45,7 @@ public:
     VariableDeclaration();
     VariableDeclaration(Expression* val, bool c);
     VariableDeclaration(Expression* val, bool c, std::string id);
+    VariableDeclaration(Expression* val, bool c, std::string id, Symbol s);
     VariableDeclaration(std::string id, bool c);
     ~VariableDeclaration();
 
@@ -32,8 +54,12 @@ public:
 
     bool constant;
     std::string identifier;
+    Symbol symbol = NO_SYMBOL;
     Expression* expressionValue;
 
+    // Reza v trenutnem okolju, -1 ce se spremenljivka isce po imenu
+    int slot = -1;
+
     void toString();
 };
 
@@ -43,12 +69,43 @@ public:
     FunctionDeclaration(std::vector<std::string>& p);
     FunctionDeclaration(std::vector<std::string>& p, std::string& n);
     FunctionDeclaration(std::vector<std::string>& p, std::string& n, std::vector<Statement*>& b);
+    FunctionDeclaration(std::vector<std::string>& p, std::vector<Symbol>& ps, std::string& n, Symbol ns, std::vector<Statement*>& b);
     ~FunctionDeclaration();
 
     std::vector<std::string> parameters;
+    std::vector<Symbol> parameterSymbols;
     std::string name;
+    Symbol nameSymbol = NO_SYMBOL;
     std::vector<Statement*> body;
 
+    // Reza imena funkcije v okolju deklaracije, -1 ce se isce po imenu
+    int slot = -1;
+
+    // Ali so parametri in lokalne spremenljivke razresene v reze
+    bool resolved = false;
+
+    // Stevilo rez v okolju klica funkcije
+    int frameSize = 0;
+
+    // Telo, prevedeno za navidezni stroj ob prvem klicu
+    std::shared_ptr<Chunk> chunk;
+    bool compileFailed = false;
+
+    // Telo, prevedeno v zaprtja ob prvem klicu
+    // ali ob prehodu praga vrocine (runtime/tiering.h)
+    std::shared_ptr<ClosureBody> closureBody;
+
+    // Vrocina funkcije: stevilo klicev in povratnih skokov zank v telesu
+    uint32_t calls = 0;
+    uint32_t backEdges = 0;
+
+    // Telo, prevedeno v strojno kodo ob prehodu praga vrocine, ce racuna le s stevili
+    std::shared_ptr<JitCode> jitCode;
+    bool jitFailed = false;
+
+    // Prototip zaprtij te deklaracije, ce se obstaja kaksno zaprtje
+    std::weak_ptr<FunctionPrototype> prototype;
+
     void toString();
 };
 
@@ -63,23 +120,70 @@ public:
     std::vector<Statement*> body;
     std::vector<Statement*> alternate;
 
+    // Stevilo rez v okoljih obeh vej
+    int bodyFrameSize = 0;
+    int alternateFrameSize = 0;
+
     void toString();
 };
 
+// Zanka dokler (pogoj) {} ali za (zacetek; pogoj; korak) {}
+// Zanka dokler nima zacetka in koraka
+class LoopStatement : public Statement {
+public:
+    LoopStatement(Expression* t, std::vector<Statement*> b);
+    LoopStatement(Statement* i, Expression* t, Expression* u, std::vector<Statement*> b);
+
+    // Manjkajoc zacetek ali korak je nullptr, manjkajoc pogoj je vedno resnicen
+    Statement* init = nullptr;
+    Expression* test = nullptr;
+    Expression* update = nullptr;
+    std::vector<Statement*> body;
+
+    // Okolje zanke za spremenljivko, deklarirano v zacetku
+    // Ustvari se enkrat, zato korak spremenljivko posodablja na mestu
+    bool loopScope = false;
+    int loopFrameSize = 0;
+
+    // Telo dobi novo okolje v vsaki ponovitvi le, ce deklarira spremenljivke
+    bool bodyScope = false;
+    int bodyFrameSize = 0;
+
+    // Funkcija, v telesu katere je zanka (nullptr na vrhnjem nivoju programa)
+    FunctionDeclaration* function = nullptr;
+
+    // Povratni skoki zanke na vrhnjem nivoju in zanka, prevedena, ko postane vroca
+    uint32_t backEdges = 0;
+    std::shared_ptr<ClosureLoop> compiled;
+};
+
 class Iden : public Expression {
 public:
     Iden(std::string val);
+    Iden(std::string val, Symbol s);
 
     std::string value = "";
+    Symbol symbol = NO_SYMBOL;
+
+    // Staticna razresitev: stevilo starsevskih okolij in reza v njem
+    // depth -1 pomeni, da se spremenljivka isce po imenu
+    int depth = -1;
+    int slot = -1;
+    bool constant = false;
+
+    // Predpomnilnik iskanja po imenu (runtime/inlinecache.h)
+    // Veljaven, dokler se verzija imenovanih vezav ne spremeni
+    Binding* cachedBinding = nullptr;
+    uint64_t cachedVersion = 0;
 
     void toString();
 };
 
 class NumericLiteral : public Expression {
 public:
-    NumericLiteral(float val);
+    NumericLiteral(double val);
 
-    float value;
+    double value;
 
     void toString();
 };
@@ -87,8 +191,18 @@ public:
 class StringLiteral : public Expression {
 public:
     StringLiteral(std::string val);
+    StringLiteral(std::string val, Symbol s);
 
     std::string value;
+    Symbol symbol = NO_SYMBOL;
+};
+
+// Jezik nima logicnih literalov, nastanejo pri zlaganju konstant (runtime/optimizer.h)
+class BooleanLiteral : public Expression {
+public:
+    BooleanLiteral(bool val);
+
+    bool value;
 };
 
 class AssignmentExpression : public Expression {
@@ -100,13 +214,25 @@ public:
     Expression* value;
 };
 
+// Specializacija binarnega izraza glede na tipe operandov (runtime/quicken.h)
+enum BinaryQuickening : uint8_t {
+    QUICKEN_NONE,   // izraz se ni bil izveden
+    QUICKEN_NUMBER, // oba operanda sta bila stevili, preverja se le tip
+    QUICKEN_GENERIC // splosna pot, tudi po despecializaciji
+};
+
 class BinaryExpression : public Expression {
 public:
-    BinaryExpression(Expression* l, Expression* r, const std::string& op);
+    BinaryExpression(Expression* l, Expression* r, OperatorType op);
 
     Expression* left;
     Expression* right;
-    std::string oper;
+    OperatorType oper;
+    BinaryQuickening quickening = QUICKEN_NONE;
+
+    // Oba operanda sta dokazano stevili (runtime/typeinfer.h),
+    // izraz se racuna z double brez preverjanja tipov
+    bool unboxed = false;
 
     void toString();
 };
@@ -121,6 +247,11 @@ class MemberExpression : public Expression {
     Expression* object = nullptr;
     Expression* property = nullptr;
     bool computed;
+
+    // Predpomnilnik lastnosti (runtime/inlinecache.h)
+    // Veljaven za objekte z obliko cachedShape, lastnost je v rezi cachedSlot
+    const Shape* cachedShape = nullptr;
+    uint32_t cachedSlot = 0;
 };
 
 class CallExpression : public Expression {
@@ -133,6 +264,10 @@ public:
     Expression* caller;
     std::string oper;
 
+    // Klic je zadnji stavek telesa funkcije (lahko znotraj vej pogojnega stavka),
+    // zato lahko ponovno uporabi okvir klicoce funkcije
+    bool tail = false;
+
     void toString();
 };
 
@@ -141,9 +276,14 @@ public:
     Property();
     Property(NodeType k, std::string ke);
     Property(NodeType k, std::string ke, Expression* val);
+    Property(NodeType k, std::string ke, Symbol s, Expression* val);
 
     std::string key;
+    Symbol symbol = NO_SYMBOL;
     Expression* value;
+
+    // Reza lastnosti v objektih literala (runtime/shape.h)
+    uint32_t slot = 0;
 };
 
 class ObjectLiteral : public Expression {
@@ -152,6 +292,9 @@ public:
     ObjectLiteral(std::vector<Property*> p);
 
     std::vector<Property*> properties;
+
+    // Oblika objektov literala, dolocena ob prvi evalvaciji
+    Shape* shape = nullptr;
 };
 
 #endif
\ No newline at end of file
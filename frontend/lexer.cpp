@@ -1,136 +1,164 @@
 #include "lexer.h"
 
-template <typename T> T shiftVector(std::vector<T>& vec) {
-    T frontElement = {};
-    if (!vec.empty()) {
-        frontElement = vec.front();
-        vec.erase(vec.begin());
-    }
-    return frontElement;
-}
-
-std::unordered_map<std::string, TokenType> keywords = {
+std::unordered_map<std::string_view, TokenType> keywords = {
     {"rezerviraj", Let},
     {"konstanta", Const},
     {"funkcija", Fn},
     {"ce", If},
-    {"sicer", Else}
+    {"sicer", Else},
+    {"dokler", While},
+    {"za", For}
 };
 
-std::vector<Token> tokenize(std::string sourceCode) {
+/**
+ * Split the source code into tokens in a single pass.
+ *
+ * The scanner walks a cursor over the source buffer and emits tokens that
+ * only reference their lexeme by offset and length, so no per-character
+ * strings are allocated.
+ *
+ * @param sourceCode The source code to tokenize.
+ * @return The tokens, terminated by an EndOfFile token.
+ */
+std::vector<Token> tokenize(std::string_view sourceCode) {
     std::vector<Token> tokens;
-    std::vector<std::string> src = split(sourceCode);
-    // std::cout << "Source code: " << sourceCode << std::endl;
-    while (!src.empty()) {
-        if (src[0][0] == '(') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::OpenParen));
-        } else if (src[0][0] == ')') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::CloseParen));
-        } else if (src[0][0] == '{') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::OpenBrace));
-        } else if (src[0][0] == '}') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::CloseBrace));
-        } else if (src[0][0] == '[') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::OpenBracket));
-        } else if (src[0][0] == ']') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::CloseBracket));
-        } else if (isBinaryOperator(src[0][0])) {
-            tokens.emplace_back(token(shiftVector(src), TokenType::BinaryOperator));
-        } else if (src[0][0] == '=') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Equals));
-            if(src[0][0] == '=') {
-                tokens.back().value += shiftVector(src);
-                tokens.back().type = TokenType::EqualEquals;
+    tokens.reserve(sourceCode.size() / 4 + 1);
+
+    const size_t end = sourceCode.size();
+    size_t pos = 0;
+
+    // Check if the character after the cursor matches
+    auto next = [&](char expected) {
+        return pos + 1 < end && sourceCode[pos + 1] == expected;
+    };
+
+    while (pos < end) {
+        const char c = sourceCode[pos];
+        const size_t start = pos;
+
+        switch (c) {
+        case '(':
+            tokens.emplace_back(token(TokenType::OpenParen, pos++, 1));
+            continue;
+        case ')':
+            tokens.emplace_back(token(TokenType::CloseParen, pos++, 1));
+            continue;
+        case '{':
+            tokens.emplace_back(token(TokenType::OpenBrace, pos++, 1));
+            continue;
+        case '}':
+            tokens.emplace_back(token(TokenType::CloseBrace, pos++, 1));
+            continue;
+        case '[':
+            tokens.emplace_back(token(TokenType::OpenBracket, pos++, 1));
+            continue;
+        case ']':
+            tokens.emplace_back(token(TokenType::CloseBracket, pos++, 1));
+            continue;
+        case ';':
+            tokens.emplace_back(token(TokenType::Semicolon, pos++, 1));
+            continue;
+        case ':':
+            tokens.emplace_back(token(TokenType::Colon, pos++, 1));
+            continue;
+        case ',':
+            tokens.emplace_back(token(TokenType::Comma, pos++, 1));
+            continue;
+        case '.':
+            tokens.emplace_back(token(TokenType::Dot, pos++, 1));
+            continue;
+        case '+':
+            tokens.emplace_back(token(TokenType::Plus, pos++, 1));
+            continue;
+        case '-':
+            tokens.emplace_back(token(TokenType::Minus, pos++, 1));
+            continue;
+        case '*':
+            tokens.emplace_back(token(TokenType::Star, pos++, 1));
+            continue;
+        case '/':
+            tokens.emplace_back(token(TokenType::Slash, pos++, 1));
+            continue;
+        case '%':
+            tokens.emplace_back(token(TokenType::Percent, pos++, 1));
+            continue;
+        case '=':
+            if (next('=')) {
+                tokens.emplace_back(token(TokenType::EqualEquals, pos, 2));
+                pos += 2;
+            } else {
+                tokens.emplace_back(token(TokenType::Equals, pos++, 1));
             }
-        } else if (src[0][0] == ';') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Semicolon));
-        } else if (src[0][0] == ':') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Colon));
-        } else if (src[0][0] == ',') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Comma));
-        } else if (src[0][0] == '.') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Dot));
-        } else if (src[0][0] == '"') {
-            std::string str = "";
-            shiftVector(src);
-            while (src[0][0] != '"') {
-                str += shiftVector(src);
+            continue;
+        case '!':
+            if (next('=')) {
+                tokens.emplace_back(token(TokenType::BangEquals, pos, 2));
+                pos += 2;
+            } else {
+                tokens.emplace_back(token(TokenType::Bang, pos++, 1));
             }
-            shiftVector(src);
-            tokens.emplace_back(token(str, TokenType::String));
-        } else if (src[0][0] == '!') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Bang));
-            if(src[0][0] == '=') {
-                tokens.back().value += shiftVector(src);
-                tokens.back().type = TokenType::BangEquals;
+            continue;
+        case '<':
+            if (next('=')) {
+                tokens.emplace_back(token(TokenType::LessEquals, pos, 2));
+                pos += 2;
+            } else {
+                tokens.emplace_back(token(TokenType::Less, pos++, 1));
             }
-        } else if (src[0][0] == '<') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Less));
-            if(src[0][0] == '=') {
-                tokens.back().value += shiftVector(src);
-                tokens.back().type = TokenType::LessEquals;
+            continue;
+        case '>':
+            if (next('=')) {
+                tokens.emplace_back(token(TokenType::GreaterEquals, pos, 2));
+                pos += 2;
+            } else {
+                tokens.emplace_back(token(TokenType::Greater, pos++, 1));
             }
-        } else if (src[0][0] == '>') {
-            tokens.emplace_back(token(shiftVector(src), TokenType::Greater));
-            if(src[0][0] == '=') {
-                tokens.back().value += shiftVector(src);
-                tokens.back().type = TokenType::GreaterEquals;
+            continue;
+        case '"': {
+            // The span of a string token covers only its contents, without quotes
+            size_t close = sourceCode.find('"', pos + 1);
+            if (close == std::string_view::npos) {
+                throw std::runtime_error("Lexer error: Unterminated string literal.");
             }
-        } else {
-            // Check if a token is a number
-            if (isNumber(src[0][0])) {
-                std::string num = "";
-                while (!src.empty() && !src[0].empty() && isNumber(src[0][0])) {
-                    num += src[0].front();
-                    src.erase(src.begin());
-                }
-                tokens.emplace_back(token(num, TokenType::Number));
+            std::string_view contents = sourceCode.substr(pos + 1, close - pos - 1);
+            tokens.emplace_back(token(TokenType::String, pos + 1, contents.size(), symbols().intern(contents)));
+            pos = close + 1;
+            continue;
+        }
+        default:
+            break;
+        }
+
+        // Check if a token is a number
+        if (isNumber(c)) {
+            while (pos < end && isNumber(sourceCode[pos])) {
+                pos++;
             }
-            // Check if a token is an identifier
-            else if (isAlpha(src[0][0])) {
-                std::string identifier = "";
-                // std::cout << "Identifier: " << src[0][0] << std::endl;
-                while (!src.empty() && !src[0].empty() && isAlpha(src[0][0])) {
-                    // std::cout << "Shifting: " << src[0][0] << std::endl;
-                    // std::cout << "Identifier: " << identifier << std::endl;
-                    identifier += src[0].front();
-                    src.erase(src.begin());
-                    // std::cin.get();
-                }
-                bool isKeyword = false;
-                for (const auto& pair : keywords) {
-                    if(identifier == pair.first) {
-                        isKeyword = true;
-                        // std::cout << "Keyword: " << pair.first << std::endl;
-                        tokens.emplace_back(token(identifier, pair.second));
-                    }
-                }
-                if(!isKeyword) {
-                    // std::cout << identifier << std::endl;
-                    tokens.emplace_back(token(identifier, TokenType::Identifier));
-                }
-                // std::cout << type->second << std::endl;
-                // if (it != keywords.end()) {
-                    
-                // 
-                // } else {
-                //     tokens.emplace_back(token(identifier, TokenType::Identifier));
-                // 
-                // }
+            tokens.emplace_back(token(TokenType::Number, start, pos - start));
+        }
+        // Check if a token is an identifier or a keyword
+        else if (isAlpha(c)) {
+            while (pos < end && isAlpha(sourceCode[pos])) {
+                pos++;
             }
-            // Check if a token is a skippable character
-            else if (isSkippable(src[0][0])) {
-                src.erase(src.begin());
+            std::string_view word = sourceCode.substr(start, pos - start);
+            auto keyword = keywords.find(word);
+            if (keyword != keywords.end()) {
+                tokens.emplace_back(token(keyword->second, start, word.size()));
             } else {
-                exit(1);
+                // Names are interned once here, later stages only compare symbols
+                tokens.emplace_back(token(TokenType::Identifier, start, word.size(), symbols().intern(word)));
             }
         }
+        // Check if a token is a skippable character
+        else if (isSkippable(c)) {
+            pos++;
+        } else {
+            std::cerr << "Unrecognized character found during lexing: '" << c << "' at offset " << pos << std::endl;
+            exit(1);
+        }
     }
-    tokens.emplace_back(token("EndOfFile", TokenType::EndOfFile));
-
-    // for (const auto& token : tokens) {
-    //     std::cout << "Token: " << tokenTypeToString(token.type) << " (" << token.value << ")" << std::endl;
-    // }
+    tokens.emplace_back(token(TokenType::EndOfFile, end, 0));
 
     return tokens;
 }
\ No newline at end of file
@@ -3,8 +3,8 @@
 
 #include "Functions.h"
 
-template <typename T> T shiftVector(std::vector<T>& vec);
-
-std::vector<Token> tokenize(std::string sourceCode);
+// Tokeni hranijo le odmik in dolzino v izvorni kodi,
+// zato mora izvorna koda ziveti vsaj toliko casa kot tokeni
+std::vector<Token> tokenize(std::string_view sourceCode);
 
 #endif
\ No newline at end of file
@@ -1,17 +1,31 @@
 #include "parser.h"
 
-Token Parser::at() {
-    return this->tokens[0];
+#include <array>
+
+std::string_view Parser::text(const Token& token) const {
+    return lexeme(this->source, token);
+}
+
+const Token& Parser::at() const {
+    return this->tokens[this->position];
 }
 
-Token Parser::eat() {
-    Token prev = *tokens.begin();
-    this->tokens.erase(this->tokens.begin());
+const Token& Parser::peek(size_t offset) const {
+    // The last token is always EndOfFile, so looking past it yields EndOfFile
+    size_t index = std::min(this->position + offset, this->tokens.size() - 1);
+    return this->tokens[index];
+}
+
+const Token& Parser::eat() {
+    const Token& prev = this->tokens[this->position];
+    if (prev.type != EndOfFile) {
+        this->position++;
+    }
     return prev;
 }
 
-Token Parser::expect(TokenType type, std::string err) {
-    Token prev = this->eat();
+const Token& Parser::expect(TokenType type, std::string err) {
+    const Token& prev = this->eat();
     if (prev.type != type) {
         throw std::runtime_error("Parser error: " + err + " - Expecting " + tokenTypeToString(type) + " got " + tokenTypeToString(prev.type));
     }
@@ -19,8 +33,8 @@ Token Parser::expect(TokenType type, std::string err) {
 }
 
 
-bool Parser::not_eof() {
-    return this->tokens[0].type != EndOfFile;
+bool Parser::not_eof() const {
+    return this->at().type != EndOfFile;
 }
 
 Statement* Parser::parseStatement() {
@@ -36,6 +50,10 @@ Statement* Parser::parseStatement() {
     case If:
         // std::cout << "Parsing if statement" << std::endl;
         return this->parseIfStatement();
+    case While:
+        return this->parseWhileStatement();
+    case For:
+        return this->parseForStatement();
     default:
         //  std::cout << "Parsing expression" << std::endl;
         return this->parseExpression();
@@ -62,10 +80,11 @@ Statement* Parser::parseIfStatement() {
     std::vector<Statement*> alternate = {};
 
     if(this->at().type == Else) {
-        this->eat();
-        if(this->at().type == If) {
+        if(this->peek(1).type == If) {
+            this->eat();
             alternate.push_back(this->parseIfStatement());
         }else {
+            this->eat();
             this->eat();
             while(this->not_eof() && this->at().type != CloseBrace) {
                 alternate.push_back(this->parseStatement());
@@ -75,19 +94,82 @@ Statement* Parser::parseIfStatement() {
     }
     // std::cout << "Success!" << std::endl;
     // std::cout << "Test expression: " << test->getKindName() << std::endl;
-    return dynamic_cast<Statement*>(new IfStatement(test, body, alternate));
+    return dynamic_cast<Statement*>(this->arena->make<IfStatement>(test, body, alternate));
+}
+
+std::vector<Statement*> Parser::parseBlock(const std::string& err) {
+    this->expect(OpenBrace, "Expected '{' before " + err + ".");
+
+    std::vector<Statement*> body = {};
+    while(this->not_eof() && this->at().type != CloseBrace) {
+        body.push_back(this->parseStatement());
+    }
+
+    this->expect(CloseBrace, "Expected '}' after " + err + ".");
+    return body;
+}
+
+Statement* Parser::parseWhileStatement() {
+    this->eat();
+    this->expect(OpenParen, "Expected '(' after dokler keyword.");
+
+    Expression* test = this->parseExpression();
+    this->expect(CloseParen, "Expected ')' after loop condition.");
+
+    std::vector<Statement*> body = this->parseBlock("loop body");
+    return this->arena->make<LoopStatement>(test, body);
+}
+
+/**
+ * Parse a counted loop: za (rezerviraj i = 0; i < n; i = i + 1) { ... }
+ * Each of the three clauses may be left empty.
+ *
+ * @return The loop statement.
+ */
+Statement* Parser::parseForStatement() {
+    this->eat();
+    this->expect(OpenParen, "Expected '(' after za keyword.");
+
+    Statement* init = nullptr;
+    if(this->at().type == Let || this->at().type == Const) {
+        // The declaration consumes its own semicolon
+        init = this->parseVariableDeclaration();
+    } else {
+        if(this->at().type != Semicolon) {
+            init = this->parseExpression();
+        }
+        this->expect(Semicolon, "Expected ';' after loop initializer.");
+    }
+
+    Expression* test = nullptr;
+    if(this->at().type != Semicolon) {
+        test = this->parseExpression();
+    }
+    this->expect(Semicolon, "Expected ';' after loop condition.");
+
+    Expression* update = nullptr;
+    if(this->at().type != CloseParen) {
+        update = this->parseExpression();
+    }
+    this->expect(CloseParen, "Expected ')' after loop update.");
+
+    std::vector<Statement*> body = this->parseBlock("loop body");
+    return this->arena->make<LoopStatement>(init, test, update, body);
 }
 
 Statement* Parser::parseFunctionDeclaration() {
     this->eat();
-    std::string name = this->expect(Identifier, "Expected function name following funkcija keyword.").value;
+    const Token& nameToken = this->expect(Identifier, "Expected function name following funkcija keyword.");
+    std::string name(this->text(nameToken));
     std::vector<Expression*> args = this->parseArgs();
     std::vector<std::string> params = {};
+    std::vector<Symbol> paramSymbols = {};
     for(auto arg : args) {
         if(arg->getKind() != NodeType::NODE_IDENTIFIER) {
             throw std::runtime_error("Inside function declaration expected to be of type string.");
         }
         params.push_back(dynamic_cast<Iden*>(arg)->value);
+        paramSymbols.push_back(dynamic_cast<Iden*>(arg)->symbol);
     }
     this->expect(OpenBrace, "Expected function body declaration.");
 
@@ -99,29 +181,32 @@ Statement* Parser::parseFunctionDeclaration() {
 
     this->expect(CloseBrace, "Expected closing brace inside function declaration.");
     
-    return dynamic_cast<Statement*>(new FunctionDeclaration(params, name, body));
+    return dynamic_cast<Statement*>(this->arena->make<FunctionDeclaration>(params, paramSymbols, name, nameToken.symbol, body));
 }
 
 Statement* Parser::parseVariableDeclaration() {
     bool isConstant = this->eat().type == Const;
-    std::string identifier = this->expect(Identifier, "Expected identifier name following rezerviraj | konstanta keywords.").value;
+    const Token& identifierToken = this->expect(Identifier, "Expected identifier name following rezerviraj | konstanta keywords.");
+    std::string identifier(this->text(identifierToken));
     if(this->at().type == Semicolon) {
         this->eat();
         if(isConstant) {
             throw std::runtime_error("Constants must be initialized. No value provided.");
         }
-        VariableDeclaration* dec = new VariableDeclaration(
+        VariableDeclaration* dec = this->arena->make<VariableDeclaration>(
             this->parseExpression(),
             isConstant,
-            identifier
+            identifier,
+            identifierToken.symbol
         );
         return dynamic_cast<Statement*>(dec);
     }
     this->expect(Equals, "Expected equals sign following identifier in var declaration.");
-    VariableDeclaration* declaration = new VariableDeclaration(
+    VariableDeclaration* declaration = this->arena->make<VariableDeclaration>(
         this->parseExpression(),
         isConstant,
-        identifier
+        identifier,
+        identifierToken.symbol
     );
     this->expect(Semicolon, "Variable declaration statement must end with semicolon.");
     return dynamic_cast<Statement*>(declaration);
@@ -136,7 +221,7 @@ Expression*  Parser::parseAssignmentExpression() {
     if(this->at().type == Equals) {
         this->eat();
         Expression* value = this->parseAssignmentExpression();
-        return dynamic_cast<Expression*>(new AssignmentExpression(left, value));
+        return dynamic_cast<Expression*>(this->arena->make<AssignmentExpression>(left, value));
     }
     // if(this->at().type == GreaterEquals) {
     //     this->eat();
@@ -150,7 +235,7 @@ Expression*  Parser::parseAssignmentExpression() {
 
 Expression* Parser::parseObjectExpression() {
     if(this->at().type != OpenBrace) {
-        return this->parseAdditiveExpression();
+        return this->parseBinaryExpression(1);
     }
 
     this->eat(); // Advance past open brace
@@ -162,15 +247,18 @@ Expression* Parser::parseObjectExpression() {
 
         // { key }
 
-        std::string key = this->expect(Identifier, "Object literal key expected.").value;
+        const Token& keyToken = this->expect(Identifier, "Object literal key expected.");
+        std::string key(this->text(keyToken));
+        Symbol symbol = keyToken.symbol;
 
         // Allows shorthand: key: pair -> key
+        // The shorthand reads the variable of the same name, so it is stored as { key: key }
         if(this->at().type == Comma) {
             this->eat();
-            properties.push_back(new Property(NODE_PROPERTY, key, nullptr));
+            properties.push_back(this->arena->make<Property>(NODE_PROPERTY, key, symbol, this->arena->make<Iden>(key, symbol)));
             continue;
         } else if(this->at().type == CloseBrace) {
-            properties.push_back(new Property(NODE_PROPERTY, key, nullptr));
+            properties.push_back(this->arena->make<Property>(NODE_PROPERTY, key, symbol, this->arena->make<Iden>(key, symbol)));
             continue;
         }
 
@@ -179,7 +267,7 @@ Expression* Parser::parseObjectExpression() {
         this->expect(Colon, "Missing colon following identifier in ObjectExpression.");
         Expression* value = this->parseExpression();
 
-        properties.push_back(new Property(NODE_PROPERTY, key, value));
+        properties.push_back(this->arena->make<Property>(NODE_PROPERTY, key, symbol, value));
         // std::cout << "key: " << key << "\tvalue: " << value->getValue() << std::endl;
 
         if(this->at().type != CloseBrace) {
@@ -189,36 +277,58 @@ Expression* Parser::parseObjectExpression() {
 
     this->expect(CloseBrace, "Expected close brace to terminate object expression.");
 
-    return dynamic_cast<Expression*>(new ObjectLiteral(properties));
+    return dynamic_cast<Expression*>(this->arena->make<ObjectLiteral>(properties));
 }
 
-Expression* Parser::parseAdditiveExpression() {
-    Expression* left = this->parseMultiplicativeExpression();
-
-    while(this->at().value == "+" || 
-          this->at().value == "-" || 
-          this->at().value == "==" || 
-          this->at().value == "!=" || 
-          this->at().value == ">" || 
-          this->at().value == "<" || 
-          this->at().value == ">=" || 
-          this->at().value == "<=") 
-    {
-        std::string op = this->eat().value;
-        Expression* right = this->parseMultiplicativeExpression();
-        left = new BinaryExpression(left, right, op);
-    }
+/*
+        Binary operators are parsed by precedence climbing.
+        Each operator token maps to its operator and binding power;
+        tokens that are not binary operators have precedence 0.
+        Higher precedence binds tighter.
+*/
+struct BinaryOperatorInfo {
+    OperatorType oper = OP_NONE;
+    int precedence = 0;
+    bool rightAssociative = false;
+};
 
-    return left;
+constexpr std::array<BinaryOperatorInfo, EndOfFile + 1> makeBinaryOperatorTable() {
+    std::array<BinaryOperatorInfo, EndOfFile + 1> table = {};
+
+    table[EqualEquals]   = {OP_EQUALS, 1};
+    table[BangEquals]    = {OP_NOT_EQUALS, 1};
+
+    table[Less]          = {OP_LESS, 2};
+    table[Greater]       = {OP_GREATER, 2};
+    table[LessEquals]    = {OP_LESS_EQUALS, 2};
+    table[GreaterEquals] = {OP_GREATER_EQUALS, 2};
+
+    table[Plus]          = {OP_ADD, 3};
+    table[Minus]         = {OP_SUBTRACT, 3};
+
+    table[Star]          = {OP_MULTIPLY, 4};
+    table[Slash]         = {OP_DIVIDE, 4};
+    table[Percent]       = {OP_MODULO, 4};
+
+    return table;
 }
 
-Expression* Parser::parseMultiplicativeExpression() {
+constexpr std::array<BinaryOperatorInfo, EndOfFile + 1> binaryOperators = makeBinaryOperatorTable();
+
+Expression* Parser::parseBinaryExpression(int minPrecedence) {
     Expression* left = this->parseCallMemberExpression();
 
-    while(this->at().value == "/" || this->at().value == "*" || this->at().value == "%") {
-        std::string op = this->eat().value;
-        Expression* right = this->parseCallMemberExpression();
-        left = new BinaryExpression(left, right, op);
+    while(true) {
+        const BinaryOperatorInfo& info = binaryOperators[this->at().type];
+        if(info.precedence == 0 || info.precedence < minPrecedence) {
+            break;
+        }
+        this->eat();
+
+        // Left-associative operators only let tighter operators into the right operand
+        int nextPrecedence = info.rightAssociative ? info.precedence : info.precedence + 1;
+        Expression* right = this->parseBinaryExpression(nextPrecedence);
+        left = this->arena->make<BinaryExpression>(left, right, info.oper);
     }
 
     return left;
@@ -252,7 +362,7 @@ Expression* Parser::parseCallMemberExpression() {
         ^--^
 */
 Expression* Parser::parseCallExpression(Expression* caller) {
-    Expression* callExpr = dynamic_cast<Expression*>(new CallExpression(this->parseArgs(), caller));
+    Expression* callExpr = dynamic_cast<Expression*>(this->arena->make<CallExpression>(this->parseArgs(), caller));
 
     //  If there are more open parentheses
     //  We recursively call this function
@@ -294,13 +404,13 @@ Expression* Parser::parseMemberExpression() {
     Expression* object = this->parsePrimaryExpression();
 
     while (this->at().type == Dot || this->at().type == OpenBracket) {
-        Token oper = this->eat();   // Current operator
+        TokenType oper = this->eat().type;   // Current operator
         Expression* property = nullptr;
         bool computed;
 
         // Non-computed values AKA "." - obj.expr
 
-        if(oper.type == Dot) {
+        if(oper == Dot) {
             // Get identifier
             computed = false;
             property = this->parsePrimaryExpression();
@@ -316,7 +426,7 @@ Expression* Parser::parseMemberExpression() {
             property = this->parseExpression();
             this->expect(CloseBracket, "Missing closing bracket in computed value.");
         }
-        object = dynamic_cast<Expression*>(new MemberExpression(object, property, computed));
+        object = dynamic_cast<Expression*>(this->arena->make<MemberExpression>(object, property, computed));
     }
     return dynamic_cast<Expression*>(object);
     
@@ -329,7 +439,8 @@ AssignmentExpression        |
 MemberExpression            |
 FunctionCall                |
 LogicalExpression           |
-ComparisonExpression        | 
+EqualityExpression          |   BinaryExpression (precedence climbing)
+RelationalExpression        |
 AdditiveExpression          |
 MultiplicativeExpression    |
 CallExpression              |
@@ -341,12 +452,16 @@ Expression* Parser::parsePrimaryExpression() {
     TokenType tk = this->at().type;
     Expression* value = nullptr;
     switch (tk) {
-        case Identifier:
-            return new Iden(this->eat().value);
+        case Identifier: {
+            const Token& name = this->eat();
+            return this->arena->make<Iden>(std::string(this->text(name)), name.symbol);
+        }
         case Number:
-            return new NumericLiteral(std::stof(this->eat().value));
-        case String:
-            return new StringLiteral(this->eat().value);
+            return this->arena->make<NumericLiteral>(std::stod(std::string(this->text(this->eat()))));
+        case String: {
+            const Token& literal = this->eat();
+            return this->arena->make<StringLiteral>(std::string(this->text(literal)), literal.symbol);
+        }
         case OpenParen:
             this->eat();
             value = this->parseExpression();
@@ -356,7 +471,7 @@ Expression* Parser::parsePrimaryExpression() {
             );
             return value;
         default:
-            std::cerr << "Unexpected token found during parsing: Token: " << "{ " << "type: " << tokenTypeToString(this->at()) << ", " << "value: \"" << this->at().value << "\""  " }" << std::endl;
+            std::cerr << "Unexpected token found during parsing: Token: " << "{ " << "type: " << tokenTypeToString(this->at()) << ", " << "value: \"" << this->text(this->at()) << "\""  " }" << std::endl;
             exit(1);
     }
 }
@@ -364,16 +479,21 @@ Expression* Parser::parsePrimaryExpression() {
 Program Parser::produceAST(std::string sourceCode) {
     // std::cout << "Producing AST..." << std::endl;
     // std::cout << sourceCode << std::endl;
-    this->tokens = tokenize(sourceCode);
+    this->source = std::move(sourceCode);
+    this->tokens = tokenize(this->source);
+    this->position = 0;
     Program program;
     program.setKind(NodeType::NODE_PROGRAM);
     program.body = {};
+    program.arena = std::make_shared<AstArena>();
+    this->arena = program.arena.get();
 
     // // Parse until end of file
     //   std::cout << "Parsing statement..." << std::endl;
     while (this->not_eof()) {
         program.body.push_back(this->parseStatement());
     }
+    this->arena = nullptr;
 
     return program;
 }
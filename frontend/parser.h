@@ -7,59 +7,75 @@
 
 
 // Parser 
-// Razred za razlembo doloenega "token"-a (slov. etona)
+// Razred za razèlembo doloèenega "token"-a (slov. ¾etona)
 
 class Parser {
   private:
 
+    // Izvorna koda, na katero kazejo tokeni
+    std::string source = "";
+
     // Polje tokenov
     std::vector<Token> tokens = {};
 
+    // Besedilo tokena v izvorni kodi
+    std::string_view text(const Token& token) const;
+
+    // Arena programa, ki se trenutno gradi
+    AstArena* arena = nullptr;
+
+    // Indeks trenutnega tokena
+    size_t position = 0;
+
     // Trenuten token
-    Token at();
+    const Token& at() const;
+
+    // Token, ki je za dolocen odmik pred trenutnim
+    const Token& peek(size_t offset) const;
 
     // Naslednji token
-    Token eat();
+    const Token& eat();
 
-    // Priakuj doloen token
-    Token expect(TokenType type, std::string err);
+    // Prièakuj doloèen token
+    const Token& expect(TokenType type, std::string err);
 
     // Preveri ali je token EOF
     // Pomeni konec izvorne kode
-    bool not_eof();
+    bool not_eof() const;
 
-    // Razlemba izjave
+    // Razèlemba izjave
     /*
        Deklaracija spremenljivke  rezerviraj a = 10;
        Deklaracija funkcije       funkcija a() {}
-       Odloitveni stavki         ce() {}
+       Odloèitveni stavki         ce() {}
+       Zanke                      dokler() {}, za(;;) {}
        Izrazi                     a >= 10
     */
     Statement* parseStatement();
 
-    // Razlemba izraza
+    // Razèlemba izraza
     Expression* parseExpression();
 
-    // Razlemba objekta
+    // Razèlemba objekta
     Expression* parseObjectExpression();
 
-    // Razlemba prireditve
+    // Razèlemba prireditve
     Expression* parseAssignmentExpression();
 
-    // Razlemba deklaracije spremenljivke
+    // Razèlemba deklaracije spremenljivke
     Statement* parseVariableDeclaration();
 
-    // Razlemba deklaracije funkcije
+    // Razèlemba deklaracije funkcije
     Statement* parseFunctionDeclaration();
 
-    // Razlemba matematinih izrazov ali primerjav
-    Expression* parseAdditiveExpression();
-    Expression* parseMultiplicativeExpression();
+    // Razèlemba matematiènih izrazov ali primerjav
+    // Operatorji z nizjo prednostjo od minPrecedence se ne razclenijo
+    Expression* parseBinaryExpression(int minPrecedence);
 
-    // Razlemba primarnih izrazov
+    // Razèlemba primarnih izrazov
     /*
        Identifikator
-       tevilka
+       ©tevilka
        Niz znakov
        Oklepaji () v katerih je izraz
     */
@@ -77,12 +93,21 @@ class Parser {
     // Polje argumentov
     std::vector<Expression*> parseArgumentList();
 
-    // Razlemba objekta
+    // Razèlemba objekta
     Expression* parseMemberExpression();
 
-    // Razlemba odloitvenega stavka
+    // Razèlemba odloèitvenega stavka
     Statement* parseIfStatement();
 
+    // Razclemba zanke dokler (pogoj) {}
+    Statement* parseWhileStatement();
+
+    // Razclemba zanke za (zacetek; pogoj; korak) {}
+    Statement* parseForStatement();
+
+    // Razclemba telesa zanke med zavitimi oklepaji
+    std::vector<Statement*> parseBlock(const std::string& err);
+
   public:
 
     // izdelava AST
@@ -0,0 +1,292 @@
+#include "resolver.h"
+
+/**
+ * Create a new scope nested inside the current one and make it current.
+ *
+ * @param dynamic Whether variables in the scope are looked up by name at runtime.
+ * @return The new scope.
+ */
+Resolver::Scope* Resolver::pushScope(bool dynamic) {
+    this->scopes.push_back(std::make_unique<Scope>());
+    Scope* scope = this->scopes.back().get();
+    scope->parent = this->current;
+    scope->dynamic = dynamic;
+    this->current = scope;
+    return scope;
+}
+
+/**
+ * Declare a name in the current scope.
+ *
+ * Redeclaring a name reuses its slot, so the runtime still reports
+ * "Variable already declared" when the second declaration executes.
+ *
+ * @param name The symbol of the variable's name.
+ * @param constant Whether the binding is constant.
+ * @return The slot of the variable, or -1 in a dynamic scope.
+ */
+int Resolver::declare(Symbol name, bool constant) {
+    if (this->current->dynamic) {
+        return -1;
+    }
+
+    auto it = this->current->slots.find(name);
+    if (it != this->current->slots.end()) {
+        return it->second;
+    }
+
+    int slot = (int)this->current->constants.size();
+    this->current->slots[name] = slot;
+    this->current->constants.push_back(constant);
+    return slot;
+}
+
+/**
+ * Resolve the statements of an if branch or loop body in a scope of their own,
+ * mirroring the environment created by evaluateBody.
+ *
+ * @param body The statements of the branch.
+ * @param frameSize Receives the number of slots of the branch scope.
+ */
+void Resolver::resolveBlock(std::vector<Statement*>& body, int& frameSize) {
+    Scope* scope = this->pushScope(false);
+    for (auto stmt : body) {
+        this->resolveStatement(stmt);
+    }
+    frameSize = (int)scope->constants.size();
+    this->current = scope->parent;
+}
+
+/**
+ * Check whether a body declares variables or functions of its own.
+ * Nested if branches and loops are not searched, they get their own scopes.
+ *
+ * @param body The statements of the body.
+ * @return True if the body needs an environment of its own.
+ */
+static bool declaresVariables(const std::vector<Statement*>& body) {
+    for (auto stmt : body) {
+        NodeType kind = stmt->getKind();
+        if (kind == NODE_VARIABLEDECLARATION || kind == NODE_FUNCTIONDECLARATION) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Resolve a loop. A declaration in the initializer lives in a scope that
+ * exists once for the whole loop. The body only gets a scope of its own,
+ * and with it a new environment per iteration, if it declares variables;
+ * otherwise it runs directly in the enclosing environment.
+ *
+ * @param loop The loop statement.
+ */
+void Resolver::resolveLoop(LoopStatement* loop) {
+    Scope* enclosing = this->current;
+    loop->function = this->function;
+    loop->loopScope = loop->init != nullptr && loop->init->getKind() == NODE_VARIABLEDECLARATION;
+    if (loop->loopScope) {
+        this->pushScope(false);
+    }
+
+    if (loop->init != nullptr) {
+        this->resolveStatement(loop->init);
+    }
+    this->resolveExpression(loop->test);
+    this->resolveExpression(loop->update);
+
+    loop->bodyScope = declaresVariables(loop->body);
+    if (loop->bodyScope) {
+        this->resolveBlock(loop->body, loop->bodyFrameSize);
+    } else {
+        for (auto stmt : loop->body) {
+            this->resolveStatement(stmt);
+        }
+    }
+
+    if (loop->loopScope) {
+        loop->loopFrameSize = (int)this->current->constants.size();
+    }
+    this->current = enclosing;
+}
+
+/**
+ * Resolve a function body once all enclosing scopes are complete.
+ *
+ * Bodies are resolved after the enclosing program so that they can refer
+ * to variables declared after the function itself, which is valid as long
+ * as the function is called after those declarations.
+ *
+ * @param function The declaration and the scope holding its parameters.
+ */
+void Resolver::resolveFunctionBody(PendingFunction function) {
+    this->current = function.scope;
+    this->function = function.declaration;
+    for (auto stmt : function.declaration->body) {
+        this->resolveStatement(stmt);
+    }
+    this->markTailCalls(function.declaration->body);
+    function.declaration->frameSize = (int)function.scope->constants.size();
+    function.declaration->resolved = true;
+    this->current = nullptr;
+    this->function = nullptr;
+}
+
+/**
+ * Mark the calls whose value is the value of the whole function body:
+ * a call that is the last statement, or the last statement of a branch
+ * of an if statement that is itself in tail position.
+ *
+ * @param body The statements of a function body or of a branch.
+ */
+void Resolver::markTailCalls(std::vector<Statement*>& body) {
+    if (body.empty()) {
+        return;
+    }
+    Statement* last = body.back();
+    if (last->getKind() == NODE_CALLEXPRESSION) {
+        static_cast<CallExpression*>(last)->tail = true;
+    } else if (last->getKind() == NODE_IFEXPRESSION) {
+        IfStatement* ifStmt = static_cast<IfStatement*>(last);
+        this->markTailCalls(ifStmt->body);
+        this->markTailCalls(ifStmt->alternate);
+    }
+}
+
+void Resolver::resolveStatement(Statement* stmt) {
+    switch (stmt->getKind()) {
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+        // The initializer runs before the variable exists
+        if (declaration->expressionValue != nullptr) {
+            this->resolveExpression(declaration->expressionValue);
+        }
+        declaration->slot = this->declare(declaration->symbol, declaration->constant);
+        break;
+    }
+    case NODE_FUNCTIONDECLARATION: {
+        FunctionDeclaration* declaration = static_cast<FunctionDeclaration*>(stmt);
+        declaration->slot = this->declare(declaration->nameSymbol, true);
+
+        Scope* enclosing = this->current;
+        Scope* scope = this->pushScope(false);
+        for (Symbol param : declaration->parameterSymbols) {
+            this->declare(param, false);
+        }
+        this->current = enclosing;
+
+        this->pending.push_back({declaration, scope});
+        break;
+    }
+    case NODE_IFEXPRESSION: {
+        IfStatement* ifStmt = static_cast<IfStatement*>(stmt);
+        this->resolveExpression(ifStmt->test);
+        this->resolveBlock(ifStmt->body, ifStmt->bodyFrameSize);
+        this->resolveBlock(ifStmt->alternate, ifStmt->alternateFrameSize);
+        break;
+    }
+    case NODE_LOOPSTATEMENT:
+        this->resolveLoop(static_cast<LoopStatement*>(stmt));
+        break;
+    case NODE_PROGRAM:
+        break;
+    default:
+        this->resolveExpression(static_cast<Expression*>(stmt));
+        break;
+    }
+}
+
+void Resolver::resolveExpression(Expression* expr) {
+    if (expr == nullptr) {
+        return;
+    }
+
+    switch (expr->getKind()) {
+    case NODE_IDENTIFIER:
+        this->resolveIdentifier(static_cast<Iden*>(expr));
+        break;
+    case NODE_ASSIGNMENTEXPRESSION: {
+        AssignmentExpression* assignment = static_cast<AssignmentExpression*>(expr);
+        this->resolveExpression(assignment->value);
+        this->resolveExpression(assignment->assigne);
+        break;
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        this->resolveExpression(binop->left);
+        this->resolveExpression(binop->right);
+        break;
+    }
+    case NODE_CALLEXPRESSION: {
+        CallExpression* call = static_cast<CallExpression*>(expr);
+        for (auto arg : call->args) {
+            this->resolveExpression(arg);
+        }
+        this->resolveExpression(call->caller);
+        break;
+    }
+    case NODE_MEMBEREXPRESSION: {
+        MemberExpression* member = static_cast<MemberExpression*>(expr);
+        this->resolveExpression(member->object);
+        // obj.key names a property, not a variable
+        if (member->computed) {
+            this->resolveExpression(member->property);
+        }
+        break;
+    }
+    case NODE_OBJECTLITERAL:
+        for (auto prop : static_cast<ObjectLiteral*>(expr)->properties) {
+            this->resolveExpression(prop->value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Find the innermost declaration of an identifier.
+ *
+ * The search stops at the first dynamic scope; such identifiers keep
+ * depth -1 and are looked up by name at runtime.
+ *
+ * @param iden The identifier to resolve.
+ */
+void Resolver::resolveIdentifier(Iden* iden) {
+    int depth = 0;
+    for (Scope* scope = this->current; scope != nullptr && !scope->dynamic; scope = scope->parent) {
+        auto it = scope->slots.find(iden->symbol);
+        if (it != scope->slots.end()) {
+            iden->depth = depth;
+            iden->slot = it->second;
+            iden->constant = scope->constants[it->second];
+            return;
+        }
+        depth++;
+    }
+    iden->depth = -1;
+    iden->slot = -1;
+}
+
+void Resolver::resolve(Program& program) {
+    this->scopes.clear();
+    this->pending.clear();
+    this->current = nullptr;
+
+    // The program runs directly in the (global) environment it is given
+    this->pushScope(true);
+    for (auto stmt : program.body) {
+        this->resolveStatement(stmt);
+    }
+
+    // Resolving a body can queue further nested functions
+    for (size_t i = 0; i < this->pending.size(); i++) {
+        this->resolveFunctionBody(this->pending[i]);
+    }
+}
+
+void resolveProgram(Program& program) {
+    Resolver resolver;
+    resolver.resolve(program);
+}
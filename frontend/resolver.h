@@ -0,0 +1,63 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "ast.h"
+
+#include <memory>
+
+// Staticna razresitev spremenljivk
+// Vsakemu identifikatorju, deklaraciji in prireditvi v lokalnem obsegu
+// doloci globino okolja (stevilo starsev) in rezo v tem okolju.
+// Spremenljivke globalnega obsega ostanejo dinamicne (iscejo se po imenu),
+// ker jih lahko REPL deklarira v kasnejsih vrsticah.
+// Oznaci tudi klice v repnem polozaju telesa funkcije.
+
+class Resolver {
+  private:
+    // Leksikalni obseg, ki ustreza enemu okolju med izvajanjem
+    struct Scope {
+        Scope* parent = nullptr;
+
+        // Globalni obseg, spremenljivke v njem se iscejo po imenu
+        bool dynamic = false;
+
+        // Reze deklariranih spremenljivk po simbolu imena
+        std::unordered_map<Symbol, int> slots = {};
+        std::vector<bool> constants = {};
+    };
+
+    // Vsi obsegi programa, telesa funkcij se razresijo po koncu programa
+    std::vector<std::unique_ptr<Scope>> scopes = {};
+
+    // Funkcije, katerih telesa se se niso razresila
+    struct PendingFunction {
+        FunctionDeclaration* declaration;
+        Scope* scope;
+    };
+    std::vector<PendingFunction> pending = {};
+
+    // Trenuten obseg
+    Scope* current = nullptr;
+
+    // Funkcija, katere telo se razresuje (nullptr za vrhnji nivo programa)
+    FunctionDeclaration* function = nullptr;
+
+    Scope* pushScope(bool dynamic);
+    int declare(Symbol name, bool constant);
+
+    void resolveBlock(std::vector<Statement*>& body, int& frameSize);
+    void resolveLoop(LoopStatement* loop);
+    void resolveFunctionBody(PendingFunction function);
+    void resolveStatement(Statement* stmt);
+    void resolveExpression(Expression* expr);
+    void resolveIdentifier(Iden* iden);
+    void markTailCalls(std::vector<Statement*>& body);
+
+  public:
+    // Razresi vse identifikatorje v programu
+    void resolve(Program& program);
+};
+
+void resolveProgram(Program& program);
+
+#endif
@@ -0,0 +1,22 @@
+#include "symbols.h"
+
+Symbol SymbolTable::intern(std::string_view name) {
+    auto it = this->ids.find(name);
+    if (it != this->ids.end()) {
+        return it->second;
+    }
+    Symbol symbol = (Symbol)this->names.size();
+    this->names.emplace_back(name);
+    this->ids.emplace(this->names.back(), symbol);
+    return symbol;
+}
+
+Symbol SymbolTable::find(std::string_view name) const {
+    auto it = this->ids.find(name);
+    return (it != this->ids.end()) ? it->second : NO_SYMBOL;
+}
+
+SymbolTable& symbols() {
+    static SymbolTable table;
+    return table;
+}
@@ -0,0 +1,42 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Internirano ime: gosto celo stevilo, enako za vse pojavitve istega niza
+// Imena spremenljivk, kljuci lastnosti in nizi v izvorni kodi se internirajo
+// ze v lekserju, zato se med izvajanjem primerjajo le stevila.
+using Symbol = uint32_t;
+
+// Oznaka za niz, ki ni interniran
+constexpr Symbol NO_SYMBOL = UINT32_MAX;
+
+// Tabela simbolov, skupna vsem programom
+// Simboli se nikoli ne sprostijo, zato ostanejo veljavni tudi v REPL
+class SymbolTable {
+  private:
+    // Deque ne premika nizov, zato lahko kljuci tabele kazejo nanje
+    std::deque<std::string> names = {};
+    std::unordered_map<std::string_view, Symbol> ids = {};
+
+  public:
+    // Simbol niza, ob prvi pojavitvi ga doda v tabelo
+    Symbol intern(std::string_view name);
+
+    // Simbol niza ali NO_SYMBOL, ce niz se ni interniran
+    Symbol find(std::string_view name) const;
+
+    // Niz simbola
+    const std::string& name(Symbol symbol) const { return this->names[symbol]; }
+
+    size_t size() const { return this->names.size(); }
+};
+
+// Tabela simbolov, ki jo uporabljata lekser in interpreter
+SymbolTable& symbols();
+
+#endif
@@ -1,5 +1,139 @@
 //#include "frontend/parser.h"
 #include "runtime/interpreter.h"
+#include "runtime/vm.h"
+#include "runtime/stackeval.h"
+#include "runtime/closures.h"
+#include "runtime/tiering.h"
+#include "runtime/jit.h"
+#include "runtime/optimizer.h"
+#include "runtime/typeinfer.h"
+#include "runtime/transpiler.h"
+
+// Nastavitve iz ukazne vrstice
+struct Options {
+    // Datoteka z izvorno kodo
+    std::string filename = "test.txt";
+
+    // Interaktivni nacin (REPL)
+    bool repl = false;
+
+    // Izvajanje z navideznim strojem namesto drevesnega interpreterja
+    bool useVM = false;
+
+    // Izvajanje z evalvatorjem z eksplicitnim skladom
+    bool useStack = false;
+
+    // Izvajanje z AST, prevedenim v zaprtja C++
+    bool useClosures = false;
+
+    // Najvecja globina klicev evalvatorja z eksplicitnim skladom
+    size_t maxDepth = StackEvaluator::DEFAULT_MAX_DEPTH;
+
+    // Izpis statistike zbiralnika smeti ob koncu
+    bool gcStats = false;
+
+    // Izpis stevcev izvajalnika (predpomnilniki) ob koncu
+    bool stats = false;
+
+    // Zlaganje konstant po razresevanju (--no-fold ga izklopi)
+    bool fold = true;
+
+    // Sklepanje o tipih in nepakirani izrazi (--no-infer ga izklopi)
+    bool infer = true;
+
+    // Prevajanje vrocih funkcij in zank drevesnega interpreterja (--no-tier ga izklopi)
+    bool tier = true;
+    uint32_t tierThreshold = TierSettings().threshold;
+
+    // Prevajanje vrocih stevilskih funkcij v strojno kodo (--jit)
+    // in primerjava vsakega klica z interpreterjem (--jit-verify)
+    bool jit = false;
+    bool jitVerify = false;
+
+    // Izpis programa kot enote C++ namesto izvajanja (--emit-cpp)
+    bool emitCpp = false;
+
+    // Zbiranje smeti ob vsaki alokaciji (za testiranje)
+    bool gcStress = false;
+
+    // Najvecja velikost kopice v MB (0 pomeni brez omejitve)
+    size_t heapLimitMB = 0;
+};
+
+// Prebere nastavitve iz ukazne vrstice
+// slo++ [--vm | --stack | --closure] [--max-depth=N] [--repl] [--stats] [--no-fold] [--no-infer] [--no-tier] [--tier-threshold=N] [--jit] [--jit-verify] [--emit-cpp] [--gc-stats] [--gc-stress] [--heap-limit=MB] [datoteka]
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vm") {
+            options.useVM = true;
+        } else if (arg == "--stack") {
+            options.useStack = true;
+        } else if (arg == "--closure") {
+            options.useClosures = true;
+        } else if (arg.rfind("--max-depth=", 0) == 0) {
+            options.maxDepth = std::stoul(arg.substr(12));
+        } else if (arg == "--repl") {
+            options.repl = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--no-fold") {
+            options.fold = false;
+        } else if (arg == "--no-infer") {
+            options.infer = false;
+        } else if (arg == "--no-tier") {
+            options.tier = false;
+        } else if (arg.rfind("--tier-threshold=", 0) == 0) {
+            options.tierThreshold = std::stoul(arg.substr(17));
+        } else if (arg == "--jit") {
+            options.jit = true;
+        } else if (arg == "--jit-verify") {
+            options.jit = true;
+            options.jitVerify = true;
+        } else if (arg == "--emit-cpp") {
+            options.emitCpp = true;
+        } else if (arg == "--gc-stats") {
+            options.gcStats = true;
+        } else if (arg == "--gc-stress") {
+            options.gcStress = true;
+        } else if (arg.rfind("--heap-limit=", 0) == 0) {
+            options.heapLimitMB = std::stoul(arg.substr(13));
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Neznana nastavitev: " << arg << std::endl;
+            std::cerr << "Uporaba: slo++ [--vm | --stack | --closure] [--max-depth=N] [--repl] [--stats] [--no-fold] [--no-infer] [--no-tier] [--tier-threshold=N] [--jit] [--jit-verify] [--emit-cpp] [--gc-stats] [--gc-stress] [--heap-limit=MB] [datoteka]" << std::endl;
+            exit(1);
+        } else {
+            options.filename = arg;
+        }
+    }
+    return options;
+}
+
+// Izpise zahtevano statistiko na standardni izhod za napake
+void printStats(const Options& options) {
+    if (options.stats) {
+        printRuntimeStats(std::cerr);
+    }
+    if (options.gcStats) {
+        heap().printStats(std::cerr);
+    }
+}
+
+// Izvede program z izbranim izvajalnikom
+Value execute(Program& program, Environment* env, VM& vm, const Options& options) {
+    if (options.useVM) {
+        return vm.run(program, env);
+    }
+    if (options.useStack) {
+        return StackEvaluator(options.maxDepth).run(program, env);
+    }
+    if (options.useClosures) {
+        return runClosures(program, env);
+    }
+    Statement* stmt = dynamic_cast<Statement*>(&program);
+    return evaluate(stmt, env);
+}
 
 // Prebere tekst iz datoteke
 // Vrne string v katerem se nahaja izvorna koda
@@ -25,47 +159,81 @@ std::string readTextFile(const std::string& filename) {
     return buffer.str();
 }
 
-void run() {
+void run(const Options& options) {
     Parser* parser = new Parser();
     Environment* env = createGlobalEnv();
+    VM vm;
 
-    std::string input = readTextFile("test.txt"); 
+    std::string input = readTextFile(options.filename); 
 
     std::cout << "SLO++ v0.1" << std::endl;
     Program program = parser->produceAST(input);
-    Statement* stmt = dynamic_cast<Statement*>(&program);
-    RuntimeValue* result = evaluate(stmt, env);
+    resolveProgram(program);
+    if (options.fold) {
+        foldConstants(program, env);
+    }
+    if (options.infer) {
+        inferTypes(program);
+    }
+    Value result = execute(program, env, vm, options);
+    printStats(options);
     std::cout << "Program se je koncal. Pritisnite tipko ENTER za izhod...";
     std::cin.get();
     std::cout << "Nasvidenje";
 }
 
-void slopp() {
+void emitCpp(const Options& options) {
     Parser parser;
     Environment* env = createGlobalEnv();
+
+    Program program = parser.produceAST(readTextFile(options.filename));
+    resolveProgram(program);
+    if (options.fold) {
+        foldConstants(program, env);
+    }
+    try {
+        std::cout << CppTranspiler().transpile(program, options.filename);
+    } catch (const CompileError& error) {
+        std::cerr << error.what() << std::endl;
+        std::exit(1);
+    }
+}
+
+void slopp(const Options& options) {
+    Parser parser;
+    Environment* env = createGlobalEnv();
+    VM vm;
     std::cout << "SLO++ v0.1" << std::endl;
     while (true)
     {
         std::string input = "";
         std::cout << ">>> ";
         getline(std::cin, input);
-        if(input.empty() || input == "koncaj")
+        if(input.empty() || input == "koncaj") {
+            printStats(options);
             exit(1);
+        }
         
         Program program = parser.produceAST(input);
+        resolveProgram(program);
+        if (options.fold) {
+            foldConstants(program, env);
+        }
+        if (options.infer) {
+            inferTypes(program);
+        }
         // consoleLog(program);
 
         // std::cout << "\n----------------\n\n";
 
-        Statement* stmt = dynamic_cast<Statement*>(&program);
-        RuntimeValue* result = evaluate(stmt, env);
+        Value result = execute(program, env, vm, options);
         // consoleLog(program);
-        if(dynamic_cast<NumberValue*>(result)) {
-            std::cout << dynamic_cast<NumberValue*>(result)->value << std::endl;
-        }else if(dynamic_cast<NullValue*>(result)) {
+        if(result.isNumber()) {
+            std::cout << (result.asNumber() == 0.0 ? 0.0 : result.asNumber()) << std::endl;
+        }else if(result.isNull()) {
             std::cout << "null" << std::endl;
-        }else if(dynamic_cast<BoolValue*>(result)) {
-            if (dynamic_cast<BoolValue*>(result)->value){
+        }else if(result.isBool()) {
+            if (result.asBool()){
                 std::cout << "true" << std::endl;
             }else{
                 std::cout << "false" << std::endl;
@@ -75,8 +243,26 @@ void slopp() {
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
    // Total lines of code in .cpp and .h files: 2757
-   run();
+   Options options = parseOptions(argc, argv);
+   heap().setLimit(options.heapLimitMB * 1024 * 1024);
+   heap().setStress(options.gcStress);
+   tierSettings().enabled = options.tier && !options.useVM && !options.useStack && !options.useClosures;
+   tierSettings().threshold = options.tierThreshold;
+   jitSettings().enabled = options.jit && tierSettings().enabled;
+   jitSettings().verify = options.jitVerify;
+   if (options.jit && !SLO_JIT) {
+       std::cerr << "Strojna koda je podprta le na x86-64 Linux, --jit nima ucinka." << std::endl;
+   } else if (options.jit && !tierSettings().enabled) {
+       std::cerr << "Strojna koda prevaja le vroce funkcije drevesnega interpreterja, --jit nima ucinka z --no-tier, --vm, --stack ali --closure." << std::endl;
+   }
+   if (options.emitCpp) {
+       emitCpp(options);
+   } else if (options.repl) {
+       slopp(options);
+   } else {
+       run(options);
+   }
    return 0;
 }
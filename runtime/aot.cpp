@@ -0,0 +1,125 @@
+#include "aot.h"
+
+/**
+ * Find the binding of a name, through the cache of the call site if it
+ * is valid. Same rules as the identifier caches of the interpreter.
+ *
+ * @param name The cache of the site, with the symbol and name it looks up.
+ * @param env The environment the lookup starts in.
+ * @return The binding.
+ * @throws std::runtime_error if the variable is not declared.
+ */
+static Binding* aotFindName(AotName& name, Environment* env) {
+    if (name.version == Environment::getBindingVersion()) {
+        return name.binding;
+    }
+
+    Binding* binding = env->lookupBinding(name.symbol);
+    if (binding == nullptr) {
+        throw std::runtime_error("Variable not found: " + *name.name);
+    }
+    if (Environment::bindingsCacheable()) {
+        name.binding = binding;
+        name.version = Environment::getBindingVersion();
+    }
+    return binding;
+}
+
+Value aotLookupName(AotName& name, Environment* env) {
+    return aotFindName(name, env)->value;
+}
+
+Value aotAssignName(AotName& name, Environment* env, Value value) {
+    Binding* binding = aotFindName(name, env);
+    if (binding->constant) {
+        throw std::runtime_error("Cannot modify constant variable: " + *name.name);
+    }
+    binding->value = value;
+    return value;
+}
+
+Value aotGetProperty(AotProperty& property, Value object) {
+    if (!object.isObjectOf(VALUETYPE_OBJECT)) {
+        return getProperty(object, property.key);
+    }
+
+    ObjectValue* obj = static_cast<ObjectValue*>(object.asObject());
+    if (obj->getShape() == property.shape) {
+        return obj->getSlot(property.slot);
+    }
+
+    int slot = obj->getShape()->lookup(property.key);
+    if (slot < 0) {
+        return MK_NULL();
+    }
+    property.shape = obj->getShape();
+    property.slot = (uint32_t)slot;
+    return obj->getSlot(slot);
+}
+
+Shape* aotShape(std::initializer_list<Symbol> keys) {
+    Shape* shape = Shape::root();
+    for (Symbol key : keys) {
+        if (shape->lookup(key) < 0) {
+            shape = shape->withProperty(key);
+        }
+    }
+    return shape;
+}
+
+FunctionDeclaration* aotFunction(const std::string& name, Symbol nameSymbol, std::vector<std::string> parameters,
+                                 std::vector<Symbol> parameterSymbols, int slot, bool resolved, int frameSize, AotBody body) {
+    std::string functionName = name;
+    std::vector<Statement*> statements;
+    FunctionDeclaration* declaration = new FunctionDeclaration(parameters, parameterSymbols, functionName, nameSymbol, statements);
+    declaration->slot = slot;
+    declaration->resolved = resolved;
+    declaration->frameSize = frameSize;
+
+    // callClosure runs the body as if the closure compiler had compiled it
+    declaration->closureBody = std::make_shared<ClosureBody>();
+    declaration->closureBody->last = body;
+    return declaration;
+}
+
+const std::shared_ptr<AstArena>& aotArena() {
+    static std::shared_ptr<AstArena> arena = std::make_shared<AstArena>();
+    return arena;
+}
+
+/**
+ * Call the callee stored after the arguments, like evaluateCallExpression.
+ * User functions always have a compiled body, so they go straight to
+ * callClosure and never reach the tree-walker.
+ *
+ * @param frame The arguments followed by the callee.
+ * @param argc The number of arguments.
+ * @param env The environment of the call, passed to native functions.
+ * @return The value of the call.
+ */
+Value aotCall(ArgumentFrame& frame, size_t argc, Environment* env) {
+    Value callee = frame.data()[argc];
+    if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+        return callClosure(static_cast<FunctionValue*>(callee.asObject()), frame.data(), argc);
+    }
+    if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+        return static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(frame.data(), argc), env);
+    }
+    throw std::runtime_error("Cannot call a value that is not a function.");
+}
+
+Value aotError(const std::string& message) {
+    throw std::runtime_error(message);
+}
+
+int aotMain(void (*initialize)(), void (*program)(Environment* env)) {
+    Environment* env = createGlobalEnv();
+    initialize();
+
+    std::cout << "SLO++ v0.1" << std::endl;
+    program(env);
+    std::cout << "Program se je koncal. Pritisnite tipko ENTER za izhod...";
+    std::cin.get();
+    std::cout << "Nasvidenje";
+    return 0;
+}
@@ -0,0 +1,116 @@
+#ifndef AOT_H
+#define AOT_H
+
+#include "closures.h"
+#include "shape.h"
+
+#include <cmath>
+
+// Podpora programom, prevedenim vnaprej v C++ (runtime/transpiler.h)
+// Preveden program uporablja ista okolja, reze in imenovane vezave kot
+// interpreter, zato so pomen in sporocila napak enaki. Telesa funkcij so
+// funkcije C++ z obliko TailNode, ki jih izvaja callClosure, kot da bi jih
+// prevedel ClosureCompiler, zato so klici v repnem polozaju brez rekurzije.
+
+// Predpomnilnik spremenljivke, ki se isce po imenu (kot Iden::cachedBinding)
+struct AotName {
+    Symbol symbol = NO_SYMBOL;
+    const std::string* name = nullptr;
+    Binding* binding = nullptr;
+    uint64_t version = 0;
+};
+
+// Vmesne vrednosti prevedene funkcije, vse skupaj so en koren zbiralnika smeti
+template <size_t N> class AotTemps {
+  public:
+    AotTemps() : root(this, trace) {}
+
+    Value& operator[](size_t i) { return this->values[i]; }
+
+  private:
+    Value values[N] = {};
+    Root root;
+
+    static void trace(void* pointer, Heap& heap) {
+        for (Value value : static_cast<AotTemps*>(pointer)->values) {
+            heap.markValue(value);
+        }
+    }
+};
+
+// Predpomnilnik branja lastnosti obj.kljuc (kot MemberExpression::cachedShape)
+struct AotProperty {
+    Symbol key = NO_SYMBOL;
+    const Shape* shape = nullptr;
+    uint32_t slot = 0;
+};
+
+// Telo funkcije, prevedeno vnaprej
+using AotBody = bool (*)(Environment*& env, Value& result, ArgumentFrame& args, Value& callee);
+
+Value aotLookupName(AotName& name, Environment* env);
+Value aotAssignName(AotName& name, Environment* env, Value value);
+Value aotGetProperty(AotProperty& property, Value object);
+
+// Oblika objektnega literala s kljuci v danem vrstnem redu (kot literalShape)
+Shape* aotShape(std::initializer_list<Symbol> keys);
+
+// Deklaracija funkcije s telesom, prevedenim vnaprej
+// Zivi do konca programa, tako kot vozlisca AST v interpreterju
+FunctionDeclaration* aotFunction(const std::string& name, Symbol nameSymbol, std::vector<std::string> parameters,
+                                 std::vector<Symbol> parameterSymbols, int slot, bool resolved, int frameSize, AotBody body);
+
+// Arena, ki jo hranijo prototipi funkcij prevedenega programa (prazna)
+const std::shared_ptr<AstArena>& aotArena();
+
+// Klic s kazalcem na funkcijo v args[argc] za argumenti
+Value aotCall(ArgumentFrame& frame, size_t argc, Environment* env);
+
+// Vrze napako interpreterja, vrednost je le zaradi oblike izraza
+Value aotError(const std::string& message);
+
+// Izvede preveden program tako kot slo++ datoteka
+int aotMain(void (*initialize)(), void (*program)(Environment* env));
+
+// Binarni izraz: stevila neposredno, vse ostalo po splosni poti interpreterja
+template <OperatorType OP> inline Value aotBinary(Value left, Value right) {
+    if (left.isNumber() && right.isNumber()) {
+        double l = left.asNumber();
+        double r = right.asNumber();
+        switch (OP) {
+        case OP_ADD:
+            return MK_NUMBER(l + r);
+        case OP_SUBTRACT:
+            return MK_NUMBER(l - r);
+        case OP_MULTIPLY:
+            return MK_NUMBER(l * r);
+        case OP_DIVIDE:
+            if (r != 0.0) {
+                return MK_NUMBER(l / r);
+            }
+            break;
+        case OP_MODULO:
+            if (r != 0.0) {
+                return MK_NUMBER(std::fmod(l, r));
+            }
+            break;
+        case OP_EQUALS:
+            return MK_BOOL(l == r);
+        case OP_NOT_EQUALS:
+            return MK_BOOL(l != r);
+        case OP_LESS:
+            return MK_BOOL(l < r);
+        case OP_GREATER:
+            return MK_BOOL(l > r);
+        case OP_LESS_EQUALS:
+            return MK_BOOL(l <= r);
+        case OP_GREATER_EQUALS:
+            return MK_BOOL(l >= r);
+        default:
+            break;
+        }
+    }
+    return evaluateNumericBinaryExpression(left, right, OP);
+}
+
+#endif
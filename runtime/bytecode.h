@@ -0,0 +1,95 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "values.h"
+
+#include <cstdint>
+
+class FunctionDeclaration;
+class Iden;
+class MemberExpression;
+
+// Ukazi registrskega navideznega stroja
+// R[x] je register x v trenutnem okvirju, K[x] konstanta, N[x] ime,
+// I[x] in M[x] identifikator in dostop do lastnosti s predpomnilnikom, S[x] oblika
+#define SLO_OPCODES(X)                                                      \
+    X(LOAD_CONST)       /* R[a] = K[b]                                  */ \
+    X(LOAD_NULL)        /* R[a] = null                                  */ \
+    X(GET_SLOT)         /* R[a] = reza b okolja depth (ime N[c])        */ \
+    X(SET_SLOT)         /* reza b okolja depth = R[a]                   */ \
+    X(DECLARE_SLOT)     /* deklarira rezo b trenutnega okolja z R[a]    */ \
+    X(GET_NAME)         /* R[a] = spremenljivka I[b] (ime N[c])         */ \
+    X(SET_NAME)         /* spremenljivka I[b] = R[a] (ime N[c])         */ \
+    X(DECLARE_NAME)     /* deklarira simbol c z R[a], depth = konstanta */ \
+    X(DECLARE_FUNCTION) /* R[a] = deklaracija funkcije b                */ \
+    X(ADD)              /* R[a] = R[b] + R[c]                           */ \
+    X(SUBTRACT)         /* R[a] = R[b] - R[c]                           */ \
+    X(MULTIPLY)         /* R[a] = R[b] * R[c]                           */ \
+    X(DIVIDE)           /* R[a] = R[b] / R[c]                           */ \
+    X(MODULO)           /* R[a] = R[b] % R[c]                           */ \
+    X(EQUALS)           /* R[a] = R[b] == R[c]                          */ \
+    X(NOT_EQUALS)       /* R[a] = R[b] != R[c]                          */ \
+    X(LESS)             /* R[a] = R[b] < R[c]                           */ \
+    X(GREATER)          /* R[a] = R[b] > R[c]                           */ \
+    X(LESS_EQUALS)      /* R[a] = R[b] <= R[c]                          */ \
+    X(GREATER_EQUALS)   /* R[a] = R[b] >= R[c]                          */ \
+    X(BRANCH)           /* R[a] ni bool: skok na c, false: skok na b    */ \
+    X(JUMP)             /* skok na b                                    */ \
+    X(ENTER_SCOPE)      /* novo okolje z b rezami                       */ \
+    X(LEAVE_SCOPE)      /* vrnitev v starsevsko okolje                  */ \
+    X(CALL)             /* R[a] = R[b](R[b+1] ... R[b+c])               */ \
+    X(TAIL_CALL)        /* kot CALL, a klicana funkcija zamenja okvir   */ \
+    X(NEW_OBJECT)       /* R[a] = objekt z obliko S[b], lastnosti null  */ \
+    X(SET_PROPERTY)     /* reza c objekta R[a] = R[b]                   */ \
+    X(GET_PROPERTY)     /* R[a] = R[b].M[c]                             */ \
+    X(GET_INDEX)        /* R[a] = R[b][R[c]]                            */ \
+    X(THROW)            /* napaka s sporocilom N[c]                     */ \
+    X(RETURN)           /* vrne R[a]                                    */
+
+enum OpCode : uint8_t {
+#define SLO_OPCODE_ENUM(name) BC_##name,
+    SLO_OPCODES(SLO_OPCODE_ENUM)
+#undef SLO_OPCODE_ENUM
+    BC_COUNT
+};
+
+struct Instruction {
+    OpCode op;
+    uint8_t depth;
+    uint16_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+// Prevedena koda programa ali telesa funkcije
+struct Chunk {
+    // Konstante so koreni zbiralnika smeti, dokler koda obstaja
+    Chunk() { heap().addRoots(&this->constants); }
+    ~Chunk() { heap().removeRoots(&this->constants); }
+
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    std::vector<Instruction> code = {};
+
+    // Konstante (stevila in nizi) so ustvarjene ob prevajanju
+    std::vector<Value> constants = {};
+
+    // Imena spremenljivk, lastnosti in sporocila napak
+    std::vector<std::string> names = {};
+
+    // Deklaracije funkcij, ki jih ustvari DECLARE_FUNCTION
+    std::vector<FunctionDeclaration*> functions = {};
+
+    // Vozlisca AST, katerih predpomnilnike uporabljajo GET_NAME, SET_NAME in GET_PROPERTY
+    std::vector<Iden*> identifiers = {};
+    std::vector<MemberExpression*> members = {};
+
+    // Oblike objektnih literalov, ki jih ustvari NEW_OBJECT
+    std::vector<Shape*> shapes = {};
+
+    // Stevilo registrov, ki jih potrebuje okvir
+    int registerCount = 1;
+};
+
+#endif
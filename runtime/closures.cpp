@@ -0,0 +1,571 @@
+#include "closures.h"
+#include "tiering.h"
+
+#include <cmath>
+#include <type_traits>
+
+template <OperatorType OP>
+using Operator = std::integral_constant<OperatorType, OP>;
+
+/**
+ * Call a generic factory with the operator as a compile-time constant, so
+ * that every closure is instantiated for the one operator it computes.
+ *
+ * @param op The operator of the binary expression.
+ * @param make A generic lambda taking an Operator<OP>.
+ * @return The closure made for the operator.
+ */
+template <typename Make>
+static auto selectOperator(OperatorType op, Make make) {
+    switch (op) {
+    case OP_ADD:
+        return make(Operator<OP_ADD>());
+    case OP_SUBTRACT:
+        return make(Operator<OP_SUBTRACT>());
+    case OP_MULTIPLY:
+        return make(Operator<OP_MULTIPLY>());
+    case OP_DIVIDE:
+        return make(Operator<OP_DIVIDE>());
+    case OP_MODULO:
+        return make(Operator<OP_MODULO>());
+    case OP_EQUALS:
+        return make(Operator<OP_EQUALS>());
+    case OP_NOT_EQUALS:
+        return make(Operator<OP_NOT_EQUALS>());
+    case OP_LESS:
+        return make(Operator<OP_LESS>());
+    case OP_GREATER:
+        return make(Operator<OP_GREATER>());
+    case OP_LESS_EQUALS:
+        return make(Operator<OP_LESS_EQUALS>());
+    case OP_GREATER_EQUALS:
+        return make(Operator<OP_GREATER_EQUALS>());
+    default:
+        return make(Operator<OP_NONE>());
+    }
+}
+
+/**
+ * Compute an operator on two numbers. Division and modulo by zero, and
+ * operators without a numeric result, are left to the generic path.
+ *
+ * @param l The left operand.
+ * @param r The right operand.
+ * @param result Receives the result.
+ * @return True if the result was computed.
+ */
+template <OperatorType OP>
+static inline bool numberOperation(double l, double r, Value& result) {
+    if constexpr (OP == OP_ADD) {
+        result = MK_NUMBER(l + r);
+    } else if constexpr (OP == OP_SUBTRACT) {
+        result = MK_NUMBER(l - r);
+    } else if constexpr (OP == OP_MULTIPLY) {
+        result = MK_NUMBER(l * r);
+    } else if constexpr (OP == OP_DIVIDE) {
+        if (r == 0.0) {
+            return false;
+        }
+        result = MK_NUMBER(l / r);
+    } else if constexpr (OP == OP_MODULO) {
+        if (r == 0.0) {
+            return false;
+        }
+        result = MK_NUMBER(std::fmod(l, r));
+    } else if constexpr (OP == OP_EQUALS) {
+        result = MK_BOOL(l == r);
+    } else if constexpr (OP == OP_NOT_EQUALS) {
+        result = MK_BOOL(l != r);
+    } else if constexpr (OP == OP_LESS) {
+        result = MK_BOOL(l < r);
+    } else if constexpr (OP == OP_GREATER) {
+        result = MK_BOOL(l > r);
+    } else if constexpr (OP == OP_LESS_EQUALS) {
+        result = MK_BOOL(l <= r);
+    } else if constexpr (OP == OP_GREATER_EQUALS) {
+        result = MK_BOOL(l >= r);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Run statements in an environment, the value is the one of the last statement
+static Value runStatements(const std::vector<ClosureNode>& statements, Environment* env) {
+    Value result = MK_NULL();
+    for (const ClosureNode& statement : statements) {
+        result = statement(env);
+    }
+    return result;
+}
+
+// Run statements in a new environment, like evaluateBody
+static Value runScoped(const std::vector<ClosureNode>& statements, Environment* env, int slotCount) {
+    Environment* scope = heap().allocate<Environment>(env, slotCount);
+    Root scopeRoot(scope);
+    return runStatements(statements, scope);
+}
+
+bool ClosureBody::run(Environment*& env, Value& result, ArgumentFrame& args, Value& callee) const {
+    for (const ClosureNode& statement : this->statements) {
+        statement(env);
+    }
+    if (!this->last) {
+        result = MK_NULL();
+        return false;
+    }
+    return this->last(env, result, args, callee);
+}
+
+ClosureCompiler::ClosureCompiler(std::weak_ptr<AstArena> arena) : arena(std::move(arena)) {}
+
+/**
+ * Compile an expression the type inference proved numeric into a closure
+ * that computes it on doubles.
+ *
+ * @param expr A numeric literal, a numeric slot or arithmetic over them.
+ * @return The compiled expression.
+ */
+NumberNode ClosureCompiler::compileNumber(Expression* expr) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL: {
+        double value = static_cast<NumericLiteral*>(expr)->value;
+        return [value](Environment*) { return value; };
+    }
+    case NODE_IDENTIFIER: {
+        Iden* iden = static_cast<Iden*>(expr);
+        int depth = iden->depth;
+        int slot = iden->slot;
+        return [depth, slot, iden](Environment* env) { return env->lookupSlot(depth, slot, iden->value).asNumber(); };
+    }
+    default: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        NumberNode left = this->compileNumber(binop->left);
+        NumberNode right = this->compileNumber(binop->right);
+        return selectOperator(binop->oper, [&](auto op) -> NumberNode {
+            constexpr OperatorType OP = decltype(op)::value;
+            return [left, right](Environment* env) {
+                double l = left(env);
+                double r = right(env);
+                Value result;
+                if (numberOperation<OP>(l, r, result)) {
+                    return result.asNumber();
+                }
+                // Division by zero raises the interpreter's error
+                return evaluateNumericBinaryExpression(MK_NUMBER(l), MK_NUMBER(r), OP).asNumber();
+            };
+        });
+    }
+    }
+}
+
+ClosureNode ClosureCompiler::compileBinary(BinaryExpression* binop) {
+    if (binop->unboxed) {
+        NumberNode left = this->compileNumber(binop->left);
+        NumberNode right = this->compileNumber(binop->right);
+        return selectOperator(binop->oper, [&](auto op) -> ClosureNode {
+            constexpr OperatorType OP = decltype(op)::value;
+            return [left, right](Environment* env) {
+                double l = left(env);
+                double r = right(env);
+                Value result;
+                if (numberOperation<OP>(l, r, result)) {
+                    return result;
+                }
+                return evaluateNumericBinaryExpression(MK_NUMBER(l), MK_NUMBER(r), OP);
+            };
+        });
+    }
+
+    ClosureNode left = this->compile(binop->left);
+    ClosureNode right = this->compile(binop->right);
+    return selectOperator(binop->oper, [&](auto op) -> ClosureNode {
+        constexpr OperatorType OP = decltype(op)::value;
+        return [left, right](Environment* env) {
+            Value l = left(env);
+            if (l.isNumber()) {
+                // A number holds no heap object, so it needs no root
+                Value r = right(env);
+                Value result;
+                if (r.isNumber() && numberOperation<OP>(l.asNumber(), r.asNumber(), result)) {
+                    return result;
+                }
+                return evaluateNumericBinaryExpression(l, r, OP);
+            }
+            Root leftRoot(l);
+            Value r = right(env);
+            return evaluateNumericBinaryExpression(l, r, OP);
+        };
+    });
+}
+
+/**
+ * Compile a call that is not in tail position. The arguments and the
+ * callee are kept in the shared argument buffer while the call runs.
+ */
+ClosureNode ClosureCompiler::compileCall(CallExpression* call) {
+    std::vector<ClosureNode> args;
+    for (auto arg : call->args) {
+        args.push_back(this->compile(arg));
+    }
+    ClosureNode caller = this->compile(call->caller);
+
+    return [args, caller](Environment* env) {
+        ArgumentFrame frame;
+        for (const ClosureNode& arg : args) {
+            frame.push(arg(env));
+        }
+        size_t argc = frame.size();
+
+        Value callee = caller(env);
+        frame.push(callee);
+
+        if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            // With tiering, functions that are still cold run in the tree-walker
+            FunctionValue* func = static_cast<FunctionValue*>(callee.asObject());
+            return tierSettings().enabled ? callFunction(func, frame.data(), argc) : callClosure(func, frame.data(), argc);
+        }
+        if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            return static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(frame.data(), argc), env);
+        }
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    };
+}
+
+ClosureNode ClosureCompiler::compileAssignment(AssignmentExpression* assignment) {
+    if (assignment->assigne->getKind() != NODE_IDENTIFIER) {
+        return [](Environment*) -> Value {
+            throw std::runtime_error("Invalid left-hand-side inside assignment expression.");
+        };
+    }
+
+    Iden* iden = static_cast<Iden*>(assignment->assigne);
+    ClosureNode value = this->compile(assignment->value);
+    if (iden->depth < 0) {
+        return [value, iden](Environment* env) { return assignNameCached(iden, env, value(env)); };
+    }
+    if (iden->constant) {
+        return [value, iden](Environment* env) -> Value {
+            value(env);
+            throw std::runtime_error("Cannot modify constant variable: " + iden->value);
+        };
+    }
+    int depth = iden->depth;
+    int slot = iden->slot;
+    return [value, depth, slot, iden](Environment* env) { return env->assignSlot(depth, slot, value(env), iden->value); };
+}
+
+ClosureNode ClosureCompiler::compileObject(ObjectLiteral* object) {
+    // The shape also assigns the slots of the properties
+    Shape* shape = literalShape(object);
+    std::vector<std::pair<uint32_t, ClosureNode>> properties;
+    for (auto prop : object->properties) {
+        if (prop->value == nullptr) {
+            // Shorthand { x } reads the variable by name
+            Symbol symbol = prop->symbol;
+            properties.emplace_back(prop->slot, [symbol](Environment* env) { return env->lookupVariable(symbol); });
+        } else {
+            properties.emplace_back(prop->slot, this->compile(prop->value));
+        }
+    }
+
+    return [shape, properties](Environment* env) {
+        ObjectValue* result = heap().allocate<ObjectValue>(shape);
+        Root resultRoot(result);
+        for (const auto& property : properties) {
+            result->setSlot(property.first, property.second(env));
+        }
+        return Value::object(result);
+    };
+}
+
+ClosureNode ClosureCompiler::compileIf(IfStatement* ifStmt) {
+    ClosureNode test = this->compile(ifStmt->test);
+    std::vector<ClosureNode> body = this->compileStatements(ifStmt->body);
+    std::vector<ClosureNode> alternate = this->compileStatements(ifStmt->alternate);
+    int bodySize = ifStmt->bodyFrameSize;
+    int alternateSize = ifStmt->alternateFrameSize;
+
+    return [test, body, alternate, bodySize, alternateSize](Environment* env) {
+        Value result = test(env);
+        if (!result.isBool()) {
+            return MK_NULL();
+        }
+        return result.asBool() ? runScoped(body, env, bodySize) : runScoped(alternate, env, alternateSize);
+    };
+}
+
+// Same semantics as evaluateLoopStatement
+ClosureNode ClosureCompiler::compileLoop(LoopStatement* loop) {
+    ClosureNode init = (loop->init != nullptr) ? this->compile(loop->init) : nullptr;
+    LoopNode iterations = this->compileLoopIterations(loop);
+    bool loopScope = loop->loopScope;
+    int loopSize = loop->loopFrameSize;
+
+    return [init, iterations, loopScope, loopSize](Environment* env) {
+        Environment* scope = loopScope ? heap().allocate<Environment>(env, loopSize) : env;
+        Root scopeRoot(scope);
+        if (init) {
+            init(scope);
+        }
+        return iterations(scope, MK_NULL());
+    };
+}
+
+/**
+ * Compile the part of a loop that repeats: the test, the body and the
+ * update. It starts at the test, so the tree-walker can hand over a loop
+ * between two iterations; all state of the loop is in its environment.
+ *
+ * @param loop The loop statement.
+ * @return The compiled iterations.
+ */
+LoopNode ClosureCompiler::compileLoopIterations(LoopStatement* loop) {
+    ClosureNode test = (loop->test != nullptr) ? this->compile(loop->test) : nullptr;
+    ClosureNode update = (loop->update != nullptr) ? this->compile(loop->update) : nullptr;
+    std::vector<ClosureNode> body = this->compileStatements(loop->body);
+    bool bodyScope = loop->bodyScope;
+    int bodySize = loop->bodyFrameSize;
+
+    return [test, update, body, bodyScope, bodySize](Environment* scope, Value result) {
+        Root resultRoot(result);
+        while (true) {
+            if (test) {
+                Value condition = test(scope);
+                if (!condition.isBool() || !condition.asBool()) {
+                    break;
+                }
+            }
+            result = bodyScope ? runScoped(body, scope, bodySize) : runStatements(body, scope);
+            if (update) {
+                update(scope);
+            }
+        }
+        return result;
+    };
+}
+
+std::vector<ClosureNode> ClosureCompiler::compileStatements(const std::vector<Statement*>& body) {
+    std::vector<ClosureNode> statements;
+    statements.reserve(body.size());
+    for (auto stmt : body) {
+        statements.push_back(this->compile(stmt));
+    }
+    return statements;
+}
+
+/**
+ * Compile a node into a closure computing its value.
+ *
+ * @param node The node to compile.
+ * @return The compiled node.
+ */
+ClosureNode ClosureCompiler::compile(Statement* node) {
+    switch (node->getKind()) {
+    case NODE_NUMERICLITERAL: {
+        Value value = MK_NUMBER(static_cast<NumericLiteral*>(node)->value);
+        return [value](Environment*) { return value; };
+    }
+    case NODE_BOOLEANLITERAL: {
+        Value value = MK_BOOL(static_cast<BooleanLiteral*>(node)->value);
+        return [value](Environment*) { return value; };
+    }
+    case NODE_STRINGLITERAL: {
+        // Interned strings are permanent roots
+        Value value = MK_INTERNED_STRING(static_cast<StringLiteral*>(node)->symbol);
+        return [value](Environment*) { return value; };
+    }
+    case NODE_IDENTIFIER: {
+        Iden* iden = static_cast<Iden*>(node);
+        if (iden->depth < 0) {
+            return [iden](Environment* env) { return lookupNameCached(iden, env); };
+        }
+        int depth = iden->depth;
+        int slot = iden->slot;
+        return [depth, slot, iden](Environment* env) { return env->lookupSlot(depth, slot, iden->value); };
+    }
+    case NODE_BINARYEXPRESSION:
+        return this->compileBinary(static_cast<BinaryExpression*>(node));
+    case NODE_CALLEXPRESSION:
+        return this->compileCall(static_cast<CallExpression*>(node));
+    case NODE_ASSIGNMENTEXPRESSION:
+        return this->compileAssignment(static_cast<AssignmentExpression*>(node));
+    case NODE_OBJECTLITERAL:
+        return this->compileObject(static_cast<ObjectLiteral*>(node));
+    case NODE_MEMBEREXPRESSION: {
+        MemberExpression* member = static_cast<MemberExpression*>(node);
+        ClosureNode object = this->compile(member->object);
+        if (!member->computed) {
+            return [object, member](Environment* env) { return getPropertyCached(member, object(env)); };
+        }
+        ClosureNode property = this->compile(member->property);
+        return [object, property](Environment* env) {
+            Value value = object(env);
+            Root valueRoot(value);
+            return getProperty(value, computedPropertyKey(property(env)));
+        };
+    }
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(node);
+        if (declaration->expressionValue == nullptr) {
+            break;
+        }
+        ClosureNode value = this->compile(declaration->expressionValue);
+        if (declaration->slot >= 0) {
+            int slot = declaration->slot;
+            return [value, slot, declaration](Environment* env) { return env->declareSlot(slot, value(env), declaration->identifier); };
+        }
+        return [value, declaration](Environment* env) {
+            return env->declareVariable(declaration->symbol, value(env), declaration->constant);
+        };
+    }
+    case NODE_FUNCTIONDECLARATION: {
+        FunctionDeclaration* declaration = static_cast<FunctionDeclaration*>(node);
+        std::weak_ptr<AstArena> arena = this->arena;
+        return [declaration, arena](Environment* env) {
+            // A loop compiled by tiering may outlive the program that was running at the time
+            std::shared_ptr<AstArena> owner = arena.lock();
+            return owner ? declareFunction(declaration, env, owner) : evaluateFunctionDeclaration(declaration, env);
+        };
+    }
+    case NODE_IFEXPRESSION:
+        return this->compileIf(static_cast<IfStatement*>(node));
+    case NODE_LOOPSTATEMENT:
+        return this->compileLoop(static_cast<LoopStatement*>(node));
+    default:
+        break;
+    }
+
+    // Anything else is left to the tree-walker
+    return [node](Environment* env) { return evaluate(node, env); };
+}
+
+/**
+ * Compile the last statement of a function body, or of a branch in tail
+ * position. Same semantics as evaluateUntilTailCall: a tail call hands
+ * its arguments and callee back to callClosure instead of recursing.
+ *
+ * @param node The last statement.
+ * @return The compiled statement.
+ */
+TailNode ClosureCompiler::compileTail(Statement* node) {
+    if (node->getKind() == NODE_CALLEXPRESSION && static_cast<CallExpression*>(node)->tail) {
+        CallExpression* call = static_cast<CallExpression*>(node);
+        std::vector<ClosureNode> args;
+        for (auto arg : call->args) {
+            args.push_back(this->compile(arg));
+        }
+        ClosureNode caller = this->compile(call->caller);
+        return [args, caller](Environment*& env, Value&, ArgumentFrame& frame, Value& callee) {
+            for (const ClosureNode& arg : args) {
+                frame.push(arg(env));
+            }
+            callee = caller(env);
+            return true;
+        };
+    }
+
+    if (node->getKind() == NODE_IFEXPRESSION) {
+        IfStatement* ifStmt = static_cast<IfStatement*>(node);
+        ClosureNode test = this->compile(ifStmt->test);
+        std::shared_ptr<ClosureBody> body = this->compileTailBody(ifStmt->body);
+        std::shared_ptr<ClosureBody> alternate = this->compileTailBody(ifStmt->alternate);
+        int bodySize = ifStmt->bodyFrameSize;
+        int alternateSize = ifStmt->alternateFrameSize;
+        return [test, body, alternate, bodySize, alternateSize](Environment*& env, Value& result, ArgumentFrame& frame, Value& callee) {
+            Value condition = test(env);
+            if (!condition.isBool()) {
+                result = MK_NULL();
+                return false;
+            }
+            // env is rooted by callClosure, so the branch environment is as well
+            if (condition.asBool()) {
+                env = heap().allocate<Environment>(env, bodySize);
+                return body->run(env, result, frame, callee);
+            }
+            env = heap().allocate<Environment>(env, alternateSize);
+            return alternate->run(env, result, frame, callee);
+        };
+    }
+
+    ClosureNode statement = this->compile(node);
+    return [statement](Environment*& env, Value& result, ArgumentFrame&, Value&) {
+        result = statement(env);
+        return false;
+    };
+}
+
+std::shared_ptr<ClosureBody> ClosureCompiler::compileTailBody(const std::vector<Statement*>& body) {
+    std::shared_ptr<ClosureBody> compiled = std::make_shared<ClosureBody>();
+    if (body.empty()) {
+        return compiled;
+    }
+    for (size_t i = 0; i + 1 < body.size(); i++) {
+        compiled->statements.push_back(this->compile(body[i]));
+    }
+    compiled->last = this->compileTail(body.back());
+    return compiled;
+}
+
+ClosureNode ClosureCompiler::compileProgram(Program& program) {
+    std::vector<ClosureNode> statements = this->compileStatements(program.body);
+    return [statements](Environment* env) { return runStatements(statements, env); };
+}
+
+std::shared_ptr<ClosureBody> ClosureCompiler::compileFunction(FunctionDeclaration* declaration) {
+    return this->compileTailBody(declaration->body);
+}
+
+std::shared_ptr<ClosureLoop> ClosureCompiler::compileLoopContinuation(LoopStatement* loop) {
+    std::shared_ptr<ClosureLoop> compiled = std::make_shared<ClosureLoop>();
+    compiled->iterations = this->compileLoopIterations(loop);
+    return compiled;
+}
+
+/**
+ * Call a user function, compiling its body on the first call. Calls in
+ * tail position reuse this call, like callFunction in the tree-walker.
+ *
+ * @param func The function to call.
+ * @param args The evaluated arguments, only read before the body starts running.
+ * @param argc The number of arguments.
+ * @return The value of the last statement of the function body.
+ */
+Value callClosure(FunctionValue* func, const Value* args, size_t argc) {
+    // The running function and the innermost environment stay alive while the body runs
+    Value function = Value::object(func);
+    Root functionRoot(function);
+    Environment* env = bindArguments(func, args, argc);
+    Root envRoot(env);
+
+    ArgumentFrame frame;
+    while (true) {
+        FunctionDeclaration* declaration = func->prototype->declaration;
+        if (!declaration->closureBody) {
+            declaration->closureBody = ClosureCompiler(func->prototype->arena).compileFunction(declaration);
+        }
+
+        frame.clear();
+        Value result = MK_NULL();
+        Value callee = MK_NULL();
+        if (!declaration->closureBody->run(env, result, frame, callee)) {
+            return result;
+        }
+
+        if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            function = callee;
+            func = static_cast<FunctionValue*>(callee.asObject());
+            env = bindArguments(func, frame.data(), frame.size());
+            continue;
+        }
+        if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            return static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(frame.data(), frame.size()), env);
+        }
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    }
+}
+
+Value runClosures(Program& program, Environment* env) {
+    ClosureNode root = ClosureCompiler(program.arena).compileProgram(program);
+    return root(env);
+}
@@ -0,0 +1,78 @@
+#ifndef CLOSURES_H
+#define CLOSURES_H
+
+#include "interpreter.h"
+
+#include <functional>
+
+// Izvajalnik s prevajanjem v zaprtja
+// Vsako vozlisce AST se enkrat prevede v zaprtje C++, ki ze hrani prevedene
+// otroke, izbran operator in pakirane literale. Izvajanje je le klic korenskega
+// zaprtja, brez preklapljanja po vrsti vozlisca. Telesa funkcij se prevedejo ob
+// prvem klicu in ostanejo v deklaraciji. Klici v repnem polozaju ne rekurzirajo.
+// Vozlisca, ki jih prevajalnik ne pozna, izvede drevesni interpreter.
+
+// Prevedeno vozlisce: vrednost vozlisca v danem okolju
+using ClosureNode = std::function<Value(Environment*)>;
+
+// Prevedeno stevilsko vozlisce nepakiranega izraza (runtime/typeinfer.h)
+using NumberNode = std::function<double(Environment*)>;
+
+// Zadnji stavek telesa funkcije
+// Ce je to klic v repnem polozaju, napolni argumente in klicano vrednost ter vrne true,
+// sicer vrne false in vrednost v result. Pogojni stavek okolje zamenja z okoljem veje.
+using TailNode = std::function<bool(Environment*& env, Value& result, ArgumentFrame& args, Value& callee)>;
+
+// Prevedeno telo funkcije ali veje pogojnega stavka v repnem polozaju
+struct ClosureBody {
+    // Vsi stavki razen zadnjega
+    std::vector<ClosureNode> statements = {};
+
+    // Zadnji stavek, prazen za prazno telo
+    TailNode last = nullptr;
+
+    bool run(Environment*& env, Value& result, ArgumentFrame& args, Value& callee) const;
+};
+
+// Ponovitve zanke od preverjanja pogoja dalje, v ze ustvarjenem okolju zanke
+// Vrne vrednost zadnje ponovitve telesa ali result, ce se telo ni vec izvedlo
+using LoopNode = std::function<Value(Environment* scope, Value result)>;
+
+// Zanka, prevedena med izvajanjem z drevesnim interpreterjem (runtime/tiering.h)
+struct ClosureLoop {
+    LoopNode iterations = nullptr;
+};
+
+class ClosureCompiler {
+  private:
+    // Arena vozlisc, ki jo potrebujejo nove deklaracije funkcij
+    std::weak_ptr<AstArena> arena;
+
+    ClosureNode compile(Statement* node);
+    NumberNode compileNumber(Expression* expr);
+    ClosureNode compileBinary(BinaryExpression* binop);
+    ClosureNode compileCall(CallExpression* call);
+    ClosureNode compileAssignment(AssignmentExpression* assignment);
+    ClosureNode compileObject(ObjectLiteral* object);
+    ClosureNode compileIf(IfStatement* ifStmt);
+    ClosureNode compileLoop(LoopStatement* loop);
+    LoopNode compileLoopIterations(LoopStatement* loop);
+    std::vector<ClosureNode> compileStatements(const std::vector<Statement*>& body);
+    TailNode compileTail(Statement* node);
+    std::shared_ptr<ClosureBody> compileTailBody(const std::vector<Statement*>& body);
+
+  public:
+    ClosureCompiler(std::weak_ptr<AstArena> arena);
+
+    ClosureNode compileProgram(Program& program);
+    std::shared_ptr<ClosureBody> compileFunction(FunctionDeclaration* declaration);
+    std::shared_ptr<ClosureLoop> compileLoopContinuation(LoopStatement* loop);
+};
+
+// Izvedi program s prevajanjem v zaprtja
+Value runClosures(Program& program, Environment* env);
+
+// Poklici uporabnisko funkcijo s prevedenim telesom
+Value callClosure(FunctionValue* func, const Value* args, size_t argc);
+
+#endif
@@ -0,0 +1,341 @@
+#include "compiler.h"
+
+CompileError::CompileError(const std::string& message) : std::runtime_error("Compiler error: " + message) {}
+
+int Compiler::allocateRegister() {
+    int reg = this->nextRegister++;
+    if (reg > UINT16_MAX) {
+        throw CompileError("Expression needs too many registers.");
+    }
+    this->chunk->registerCount = std::max(this->chunk->registerCount, this->nextRegister);
+    return reg;
+}
+
+void Compiler::freeRegisters(int first) {
+    this->nextRegister = first;
+}
+
+size_t Compiler::emit(OpCode op, uint32_t a, uint32_t b, uint32_t c, uint32_t depth) {
+    if (depth > UINT8_MAX) {
+        throw CompileError("Variable is nested too deeply.");
+    }
+    this->chunk->code.push_back({op, (uint8_t)depth, (uint16_t)a, b, c});
+    return this->chunk->code.size() - 1;
+}
+
+// Index of the next instruction, used as a jump target
+uint32_t Compiler::here() const {
+    return (uint32_t)this->chunk->code.size();
+}
+
+uint32_t Compiler::addConstant(Value value) {
+    this->chunk->constants.push_back(value);
+    return (uint32_t)this->chunk->constants.size() - 1;
+}
+
+uint32_t Compiler::addName(const std::string& name) {
+    auto it = std::find(this->chunk->names.begin(), this->chunk->names.end(), name);
+    if (it != this->chunk->names.end()) {
+        return (uint32_t)(it - this->chunk->names.begin());
+    }
+    this->chunk->names.push_back(name);
+    return (uint32_t)this->chunk->names.size() - 1;
+}
+
+// Variable names are deduplicated by symbol, without comparing strings
+uint32_t Compiler::addName(Symbol name) {
+    auto it = this->nameIndices.find(name);
+    if (it != this->nameIndices.end()) {
+        return it->second;
+    }
+    this->chunk->names.push_back(symbols().name(name));
+    uint32_t index = (uint32_t)this->chunk->names.size() - 1;
+    this->nameIndices.emplace(name, index);
+    return index;
+}
+
+uint32_t Compiler::addIdentifier(Iden* iden) {
+    this->chunk->identifiers.push_back(iden);
+    return (uint32_t)this->chunk->identifiers.size() - 1;
+}
+
+/**
+ * Compile a list of statements. Like the tree-walker, the value of the body
+ * is the value of its last statement, or null if it is empty.
+ *
+ * @param body The statements to compile.
+ * @param dst The register receiving the value of the body.
+ */
+void Compiler::compileBody(const std::vector<Statement*>& body, int dst) {
+    if (body.empty()) {
+        this->emit(BC_LOAD_NULL, dst);
+        return;
+    }
+    for (auto stmt : body) {
+        this->compileStatement(stmt, dst);
+    }
+}
+
+void Compiler::compileStatement(Statement* stmt, int dst) {
+    switch (stmt->getKind()) {
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+        this->compileExpression(declaration->expressionValue, dst);
+        if (declaration->slot >= 0) {
+            this->emit(BC_DECLARE_SLOT, dst, declaration->slot, this->addName(declaration->symbol));
+        } else {
+            this->emit(BC_DECLARE_NAME, dst, 0, declaration->symbol, declaration->constant ? 1 : 0);
+        }
+        break;
+    }
+    case NODE_FUNCTIONDECLARATION:
+        this->chunk->functions.push_back(static_cast<FunctionDeclaration*>(stmt));
+        this->emit(BC_DECLARE_FUNCTION, dst, (uint32_t)this->chunk->functions.size() - 1);
+        break;
+    case NODE_IFEXPRESSION:
+        this->compileIfStatement(static_cast<IfStatement*>(stmt), dst);
+        break;
+    case NODE_LOOPSTATEMENT:
+        this->compileLoop(static_cast<LoopStatement*>(stmt), dst);
+        break;
+    case NODE_PROGRAM:
+        throw CompileError("Nested programs are not supported.");
+    default:
+        this->compileExpression(static_cast<Expression*>(stmt), dst);
+        break;
+    }
+}
+
+/**
+ * Compile an if statement. A test that is not a boolean skips both
+ * branches and yields null, matching evaluateIfStatement.
+ *
+ * @param ifStmt The if statement.
+ * @param dst The register receiving the value of the taken branch.
+ */
+void Compiler::compileIfStatement(IfStatement* ifStmt, int dst) {
+    this->compileExpression(ifStmt->test, dst);
+    size_t branch = this->emit(BC_BRANCH, dst);
+
+    this->emit(BC_ENTER_SCOPE, 0, ifStmt->bodyFrameSize);
+    this->compileBody(ifStmt->body, dst);
+    this->emit(BC_LEAVE_SCOPE);
+    size_t skipAlternate = this->emit(BC_JUMP);
+
+    this->chunk->code[branch].b = this->here();
+    this->emit(BC_ENTER_SCOPE, 0, ifStmt->alternateFrameSize);
+    this->compileBody(ifStmt->alternate, dst);
+    this->emit(BC_LEAVE_SCOPE);
+    size_t skipNull = this->emit(BC_JUMP);
+
+    this->chunk->code[branch].c = this->here();
+    this->emit(BC_LOAD_NULL, dst);
+
+    this->chunk->code[skipAlternate].b = this->here();
+    this->chunk->code[skipNull].b = this->here();
+}
+
+/**
+ * Compile a dokler or za loop, matching evaluateLoopStatement. The header
+ * scope is entered once around the whole loop; the body only enters a
+ * scope per iteration if it declares variables.
+ *
+ * @param loop The loop statement.
+ * @param dst The register receiving the value of the last iteration.
+ */
+void Compiler::compileLoop(LoopStatement* loop, int dst) {
+    int first = this->nextRegister;
+    int temp = this->allocateRegister();
+
+    if (loop->loopScope) {
+        this->emit(BC_ENTER_SCOPE, 0, loop->loopFrameSize);
+    }
+    if (loop->init != nullptr) {
+        this->compileStatement(loop->init, temp);
+    }
+    this->emit(BC_LOAD_NULL, dst);
+
+    uint32_t start = this->here();
+    size_t branch = 0;
+    if (loop->test != nullptr) {
+        this->compileExpression(loop->test, temp);
+        branch = this->emit(BC_BRANCH, temp);
+    }
+
+    if (loop->bodyScope) {
+        this->emit(BC_ENTER_SCOPE, 0, loop->bodyFrameSize);
+    }
+    this->compileBody(loop->body, dst);
+    if (loop->bodyScope) {
+        this->emit(BC_LEAVE_SCOPE);
+    }
+    if (loop->update != nullptr) {
+        this->compileExpression(loop->update, temp);
+    }
+    this->emit(BC_JUMP, 0, start);
+
+    // A false test and a test that is not a boolean both leave the loop
+    if (loop->test != nullptr) {
+        this->chunk->code[branch].b = this->here();
+        this->chunk->code[branch].c = this->here();
+    }
+    if (loop->loopScope) {
+        this->emit(BC_LEAVE_SCOPE);
+    }
+    this->freeRegisters(first);
+}
+
+void Compiler::compileAssignment(AssignmentExpression* node, int dst) {
+    if (node->assigne->getKind() != NODE_IDENTIFIER) {
+        this->emit(BC_THROW, 0, 0, this->addName("Invalid left-hand-side inside assignment expression."));
+        return;
+    }
+
+    Iden* iden = static_cast<Iden*>(node->assigne);
+    this->compileExpression(node->value, dst);
+    uint32_t name = this->addName(iden->symbol);
+    if (iden->depth < 0) {
+        this->emit(BC_SET_NAME, dst, this->addIdentifier(iden), name);
+    } else if (iden->constant) {
+        this->emit(BC_THROW, 0, 0, this->addName("Cannot modify constant variable: " + iden->value));
+    } else {
+        this->emit(BC_SET_SLOT, dst, iden->slot, name, iden->depth);
+    }
+}
+
+/**
+ * Compile a call. The callee and its arguments are placed in consecutive
+ * registers; arguments are evaluated before the callee, as in the tree-walker.
+ * Calls the resolver marked as tail calls replace the calling frame.
+ *
+ * @param call The call expression.
+ * @param dst The register receiving the result of the call.
+ */
+void Compiler::compileCall(CallExpression* call, int dst) {
+    int first = this->nextRegister;
+    int base = this->allocateRegister();
+    for (size_t i = 0; i < call->args.size(); i++) {
+        this->allocateRegister();
+    }
+    for (size_t i = 0; i < call->args.size(); i++) {
+        this->compileExpression(call->args[i], base + 1 + (int)i);
+    }
+    this->compileExpression(call->caller, base);
+    this->emit(call->tail ? BC_TAIL_CALL : BC_CALL, dst, base, (uint32_t)call->args.size());
+    this->freeRegisters(first);
+}
+
+void Compiler::compileExpression(Expression* expr, int dst) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL:
+        this->emit(BC_LOAD_CONST, dst, this->addConstant(MK_NUMBER(static_cast<NumericLiteral*>(expr)->value)));
+        break;
+    case NODE_BOOLEANLITERAL:
+        this->emit(BC_LOAD_CONST, dst, this->addConstant(MK_BOOL(static_cast<BooleanLiteral*>(expr)->value)));
+        break;
+    case NODE_STRINGLITERAL:
+        this->emit(BC_LOAD_CONST, dst, this->addConstant(MK_INTERNED_STRING(static_cast<StringLiteral*>(expr)->symbol)));
+        break;
+    case NODE_IDENTIFIER: {
+        Iden* iden = static_cast<Iden*>(expr);
+        uint32_t name = this->addName(iden->symbol);
+        if (iden->depth >= 0) {
+            this->emit(BC_GET_SLOT, dst, iden->slot, name, iden->depth);
+        } else {
+            this->emit(BC_GET_NAME, dst, this->addIdentifier(iden), name);
+        }
+        break;
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        int first = this->nextRegister;
+        int left = this->allocateRegister();
+        int right = this->allocateRegister();
+        this->compileExpression(binop->left, left);
+        this->compileExpression(binop->right, right);
+
+        OpCode op;
+        switch (binop->oper) {
+            case OP_ADD: op = BC_ADD; break;
+            case OP_SUBTRACT: op = BC_SUBTRACT; break;
+            case OP_MULTIPLY: op = BC_MULTIPLY; break;
+            case OP_DIVIDE: op = BC_DIVIDE; break;
+            case OP_MODULO: op = BC_MODULO; break;
+            case OP_EQUALS: op = BC_EQUALS; break;
+            case OP_NOT_EQUALS: op = BC_NOT_EQUALS; break;
+            case OP_LESS: op = BC_LESS; break;
+            case OP_GREATER: op = BC_GREATER; break;
+            case OP_LESS_EQUALS: op = BC_LESS_EQUALS; break;
+            case OP_GREATER_EQUALS: op = BC_GREATER_EQUALS; break;
+            default:
+                throw CompileError("Unknown binary operator.");
+        }
+        this->emit(op, dst, left, right);
+        this->freeRegisters(first);
+        break;
+    }
+    case NODE_ASSIGNMENTEXPRESSION:
+        this->compileAssignment(static_cast<AssignmentExpression*>(expr), dst);
+        break;
+    case NODE_CALLEXPRESSION:
+        this->compileCall(static_cast<CallExpression*>(expr), dst);
+        break;
+    case NODE_OBJECTLITERAL: {
+        ObjectLiteral* obj = static_cast<ObjectLiteral*>(expr);
+        int first = this->nextRegister;
+        int value = this->allocateRegister();
+        this->chunk->shapes.push_back(literalShape(obj));
+        this->emit(BC_NEW_OBJECT, dst, (uint32_t)this->chunk->shapes.size() - 1);
+        for (auto prop : obj->properties) {
+            this->compileExpression(prop->value, value);
+            this->emit(BC_SET_PROPERTY, dst, value, prop->slot);
+        }
+        this->freeRegisters(first);
+        break;
+    }
+    case NODE_MEMBEREXPRESSION: {
+        MemberExpression* member = static_cast<MemberExpression*>(expr);
+        int first = this->nextRegister;
+        int object = this->allocateRegister();
+        this->compileExpression(member->object, object);
+        if (member->computed) {
+            int key = this->allocateRegister();
+            this->compileExpression(member->property, key);
+            this->emit(BC_GET_INDEX, dst, object, key);
+        } else {
+            this->chunk->members.push_back(member);
+            this->emit(BC_GET_PROPERTY, dst, object, (uint32_t)this->chunk->members.size() - 1);
+        }
+        this->freeRegisters(first);
+        break;
+    }
+    default:
+        throw CompileError("Unsupported AST node: " + expr->getKindName());
+    }
+}
+
+std::unique_ptr<Chunk> Compiler::compileProgram(Program& program) {
+    auto compiled = std::make_unique<Chunk>();
+    this->chunk = compiled.get();
+    this->nextRegister = 1;
+    this->nameIndices.clear();
+
+    this->compileBody(program.body, 0);
+    this->emit(BC_RETURN, 0);
+
+    this->chunk = nullptr;
+    return compiled;
+}
+
+std::unique_ptr<Chunk> Compiler::compileFunction(FunctionDeclaration* declaration) {
+    auto compiled = std::make_unique<Chunk>();
+    this->chunk = compiled.get();
+    this->nextRegister = 1;
+    this->nameIndices.clear();
+
+    this->compileBody(declaration->body, 0);
+    this->emit(BC_RETURN, 0);
+
+    this->chunk = nullptr;
+    return compiled;
+}
@@ -0,0 +1,54 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "bytecode.h"
+#include "../frontend/ast.h"
+
+#include <memory>
+#include <stdexcept>
+
+// Napaka, ko AST ni mogoce prevesti v bytecode
+class CompileError : public std::runtime_error {
+  public:
+    CompileError(const std::string& message);
+};
+
+// Prevajalnik iz AST v registrski bytecode
+class Compiler {
+  private:
+    // Trenutno prevajan del kode
+    Chunk* chunk = nullptr;
+
+    // Prvi prosti register
+    int nextRegister = 0;
+
+    // Indeksi imen spremenljivk v chunk->names po simbolu
+    std::unordered_map<Symbol, uint32_t> nameIndices = {};
+
+    int allocateRegister();
+    void freeRegisters(int first);
+
+    size_t emit(OpCode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t depth = 0);
+    uint32_t here() const;
+    uint32_t addConstant(Value value);
+    uint32_t addName(const std::string& name);
+    uint32_t addName(Symbol name);
+    uint32_t addIdentifier(Iden* iden);
+
+    void compileBody(const std::vector<Statement*>& body, int dst);
+    void compileStatement(Statement* stmt, int dst);
+    void compileExpression(Expression* expr, int dst);
+    void compileIfStatement(IfStatement* ifStmt, int dst);
+    void compileLoop(LoopStatement* loop, int dst);
+    void compileAssignment(AssignmentExpression* node, int dst);
+    void compileCall(CallExpression* call, int dst);
+
+  public:
+    // Prevedi celoten program, ki se izvaja v globalnem okolju
+    std::unique_ptr<Chunk> compileProgram(Program& program);
+
+    // Prevedi telo funkcije, parametre veze navidezni stroj ob klicu
+    std::unique_ptr<Chunk> compileFunction(FunctionDeclaration* declaration);
+};
+
+#endif
@@ -1,38 +1,119 @@
 #include "environment.h"
+#include "native.h"
 
-Environment::Environment() {
-    parent = nullptr;
-    variables = {};
-    constants = {};
+// Freed environments are kept here and reused by the next allocation
+static void* environmentPool = nullptr;
+
+void* Environment::operator new(size_t size) {
+    if (size != sizeof(Environment) || environmentPool == nullptr) {
+        return ::operator new(size);
+    }
+    void* block = environmentPool;
+    environmentPool = *static_cast<void**>(block);
+    return block;
+}
+
+void Environment::operator delete(void* pointer) {
+    *static_cast<void**>(pointer) = environmentPool;
+    environmentPool = pointer;
+}
+
+// Starts at 1, so that a cache that was never filled never matches
+uint64_t Environment::bindingVersion = 1;
+size_t Environment::namedEnvironments = 0;
+
+Environment::Environment() : slots(inlineSlots) {}
+
+Environment::Environment(Environment* parentENV) : parent(parentENV), slots(inlineSlots) {}
+
+Environment::Environment(Environment* parentENV, size_t slotCount) : parent(parentENV), slots(inlineSlots), slotCount((uint32_t)slotCount) {
+    if (slotCount > INLINE_SLOTS) {
+        this->overflowSlots.reset(new Value[slotCount]);
+        this->slots = this->overflowSlots.get();
+    }
+    std::fill(this->slots, this->slots + slotCount, Value::empty());
 }
 
-Environment::Environment(Environment* parentENV) {
-    const bool global = (parentENV == nullptr);
-    parent = parentENV;
-    variables = {};
-    constants = {};
+Environment::~Environment() {
+    if (this->inlineBindingCount > 0) {
+        namedEnvironments--;
+    }
 }
 
 /**
- * Check if the environment has a specific variable
- * @param varname - the name of the variable to check
- * @return true if the variable exists, false otherwise
+ * Grow the table to twice its size and reinsert every binding,
+ * keeping the load factor at or below one half.
  */
-bool Environment::hasVariable(const std::string& varname) const {
-    if (this == nullptr) {
-        return false; // Environment is null, so it doesn't have the variable
+void BindingTable::grow() {
+    std::vector<Binding> oldEntries = std::move(this->entries);
+    std::vector<bool> oldUsed = std::move(this->used);
+    size_t capacity = oldEntries.empty() ? 8 : oldEntries.size() * 2;
+    this->entries = std::vector<Binding>(capacity);
+    this->used = std::vector<bool>(capacity, false);
+    this->count = 0;
+    for (size_t i = 0; i < oldEntries.size(); i++) {
+        if (oldUsed[i]) {
+            this->insert(std::move(oldEntries[i]));
+        }
+    }
+}
+
+Binding* BindingTable::find(Symbol name) {
+    if (this->entries.empty()) {
+        return nullptr;
     }
+    size_t mask = this->entries.size() - 1;
+    for (size_t i = name & mask; this->used[i]; i = (i + 1) & mask) {
+        Binding& binding = this->entries[i];
+        if (binding.name == name) {
+            return &binding;
+        }
+    }
+    return nullptr;
+}
 
-    if (variables.empty()) {
-        return false; // Environment doesn't have any variables
+Binding* BindingTable::insert(Binding binding) {
+    if ((this->count + 1) * 2 > this->entries.size()) {
+        this->grow();
     }
+    size_t mask = this->entries.size() - 1;
+    size_t i = binding.name & mask;
+    while (this->used[i]) {
+        i = (i + 1) & mask;
+    }
+    this->used[i] = true;
+    this->entries[i] = std::move(binding);
+    this->count++;
+    return &this->entries[i];
+}
 
-    auto it = variables.find(varname);
-    if (it != variables.end()) {
-        return true; // Variable found in the environment
-    } else {
-        return false; // Variable not found in the environment
+size_t BindingTable::memorySize() const {
+    return sizeof(BindingTable) + this->entries.capacity() * sizeof(Binding) + this->used.capacity() / 8;
+}
+
+/**
+ * Find a named variable in this environment only.
+ *
+ * @param varname The symbol of the variable's name.
+ * @return The binding, or nullptr if this environment does not declare the variable.
+ */
+Binding* Environment::findBinding(Symbol varname) {
+    for (uint32_t i = 0; i < this->inlineBindingCount; i++) {
+        Binding& binding = this->inlineBindings[i];
+        if (binding.name == varname) {
+            return &binding;
+        }
     }
+    return this->table ? this->table->find(varname) : nullptr;
+}
+
+/**
+ * Check if the environment has a specific variable
+ * @param varname - the name of the variable to check
+ * @return true if the variable exists, false otherwise
+ */
+bool Environment::hasVariable(Symbol varname) {
+    return this->findBinding(varname) != nullptr;
 }
 
 
@@ -44,25 +125,42 @@ bool Environment::hasVariable(const std::string& varname) const {
  * @param value - The value to be assigned to the variable
  * @param constant - Indicates whether the variable is constant
  * @return The runtime value of the declared variable
- * @throws std::runtime_error if the value is null or if the variable is already declared
+ * @throws std::runtime_error if the value is missing or if the variable is already declared
  */
-RuntimeValue* Environment::declareVariable(const std::string& varname, RuntimeValue* value, bool constant) {
-    if (!value) {
+Value Environment::declareVariable(Symbol varname, Value value, bool constant) {
+    if (value.isEmpty()) {
         throw std::runtime_error("Cannot declare a variable with a null value");
     }
 
-    if (hasVariable(varname)) {
-        throw std::runtime_error("Variable already declared: " + varname);
+    if (this->findBinding(varname) != nullptr) {
+        throw std::runtime_error("Variable already declared: " + symbols().name(varname));
+    }
+
+    // A new binding can shadow a cached one or move the table, so cached lookups are invalidated
+    bindingVersion++;
+    if (this->inlineBindingCount == 0) {
+        namedEnvironments++;
     }
 
-    this->variables[varname] = value;
-    if (constant){
-        constants.insert(varname);
+    // The first few variables are stored inline, the rest go to the table
+    if (this->inlineBindingCount < INLINE_BINDINGS) {
+        this->inlineBindings[this->inlineBindingCount++] = {varname, value, constant};
+    } else {
+        size_t before = this->extraSize();
+        if (!this->table) {
+            this->table = std::make_unique<BindingTable>();
+        }
+        this->table->insert({varname, value, constant});
+        heap().resize(this, before);
     }
     
     return value;
 }
 
+Value Environment::declareVariable(const std::string& varname, Value value, bool constant) {
+    return this->declareVariable(symbols().intern(varname), value, constant);
+}
+
 
 /**
  * Assigns a value to the specified variable in the environment.
@@ -71,14 +169,14 @@ RuntimeValue* Environment::declareVariable(const std::string& varname, RuntimeVa
  * @param value The value to assign to the variable.
  * @return The assigned value.
  */
-RuntimeValue* Environment::assignVariable(const std::string& varname, RuntimeValue* value) {
-    Environment* env = this->resolve(varname);
+Value Environment::assignVariable(Symbol varname, Value value) {
+    Binding* binding = this->resolve(varname)->findBinding(varname);
 
     // Cannot assign a value to a constant
-    if(env->constants.find(varname) != env->constants.end()) {
-        throw std::runtime_error("Cannot modify constant variable: " + varname);
+    if(binding->constant) {
+        throw std::runtime_error("Cannot modify constant variable: " + symbols().name(varname));
     }
-    env->variables[varname] = value; 
+    binding->value = value;
 
     return value;
 }
@@ -87,101 +185,196 @@ RuntimeValue* Environment::assignVariable(const std::string& varname, RuntimeVal
  * Looks up a variable in the environment.
  * 
  * @param varname - The name of the variable to look up.
- * @return A pointer to the RuntimeValue associated with the variable.
+ * @return The value associated with the variable.
  */
-RuntimeValue* Environment::lookupVariable(const std::string& varname) {
-    Environment* env = this->resolve(varname); // Resolve the variable in the environment
-    return env->variables.find(varname)->second; // Return the value associated with the variable
+Value Environment::lookupVariable(Symbol varname) {
+    Binding* binding = this->lookupBinding(varname);
+    if (binding == nullptr) {
+        throw std::runtime_error("Variable not found: " + symbols().name(varname));
+    }
+    return binding->value;
 }
 
-RuntimeValue* Environment::lookupOrMutateObject(MemberExpression* expr, RuntimeValue* value, Iden* property) {
-    if(expr->object->getKind() == NODE_MEMBEREXPRESSION) {
-        return lookupOrMutateObject(dynamic_cast<MemberExpression*>(expr->object), value, dynamic_cast<Iden*>(expr->property));
+/**
+ * Find a named variable in this environment or any of its parents.
+ *
+ * @param varname The name of the variable.
+ * @return The innermost binding of the name, or nullptr if there is none.
+ */
+Binding* Environment::lookupBinding(Symbol varname) {
+    for (Environment* env = this; env != nullptr; env = env->parent) {
+        Binding* binding = env->findBinding(varname);
+        if (binding != nullptr) {
+            return binding;
+        }
     }
+    return nullptr;
+}
 
-    std::string varname = dynamic_cast<Iden*>(expr->object)->value;
-    Environment* env = this->resolve(varname);
+Value Environment::lookupOrMutateObject(MemberExpression* expr, Value value) {
+    if(expr->object->getKind() == NODE_MEMBEREXPRESSION) {
+        return lookupOrMutateObject(dynamic_cast<MemberExpression*>(expr->object), value);
+    }
 
-    ObjectValue* pastVal = dynamic_cast<ObjectValue*>(env->variables[varname]);
+    Iden* object = dynamic_cast<Iden*>(expr->object);
+    Value objectValue = (object->depth >= 0)
+        ? this->lookupSlot(object->depth, object->slot, object->value)
+        : this->lookupVariable(object->symbol);
 
-    std::string prop = (property != nullptr) ? property->value : dynamic_cast<Iden*>(expr->property)->value;
-    std::string currentProp = dynamic_cast<Iden*>(expr->property)->value;
+    ObjectValue* pastVal = dynamic_cast<ObjectValue*>(objectValue.asObject());
 
-    if(value != nullptr) {
-        pastVal->properties[currentProp] = value;
-    }
+    Symbol currentProp = dynamic_cast<Iden*>(expr->property)->symbol;
 
-    if(currentProp != "") {
-        pastVal = dynamic_cast<ObjectValue*>(pastVal->properties[currentProp]);
+    if(!value.isEmpty()) {
+        pastVal->setProperty(currentProp, value);
     }
 
-    return pastVal;
+    Value* found = pastVal->findProperty(currentProp);
+    return (found != nullptr) ? *found : MK_NULL();
 }
 
 // Resolves the variable by checking if it exists in the current environment.
 // If the variable exists, returns the current environment.
 // If the variable does not exist, checks the parent environment recursively.
 // Throws a runtime_error if the variable is not found in the entire environment hierarchy.
-Environment* Environment::resolve(std::string varname) {
-    if(hasVariable(varname)) {
-        return this;
-    }
-    if(this->parent == nullptr) {
-        throw std::runtime_error("Variable not found: " + varname);
+Environment* Environment::resolve(Symbol varname) {
+    for (Environment* env = this; env != nullptr; env = env->parent) {
+        if (env->findBinding(varname) != nullptr) {
+            return env;
+        }
     }
-    return this->parent->resolve(varname);
+    throw std::runtime_error("Variable not found: " + symbols().name(varname));
 }
 
-std::map<std::string, RuntimeValue*> Environment::getVariables() {
-    return this->variables;
+Environment* Environment::getParent() const {
+    return this->parent;
 }
 
-NativeFunctionValue::NativeFunctionValue() {
-    type = VALUETYPE_NATIVE_FUNCTION;
+/**
+ * Walk up the parent chain a fixed number of times.
+ *
+ * @param depth The number of parents to skip, as computed by the resolver.
+ * @return The environment that holds the resolved variable.
+ */
+Environment* Environment::ancestor(int depth) {
+    Environment* env = this;
+    while (depth-- > 0) {
+        env = env->parent;
+    }
+    return env;
 }
 
-NativeFunctionValue::NativeFunctionValue(FunctionCall call) {
-    type = VALUETYPE_NATIVE_FUNCTION;
-    this->call = call;
+/**
+ * Declare a statically resolved variable in a slot of this environment.
+ *
+ * @param slot The slot assigned by the resolver.
+ * @param value The initial value.
+ * @param varname The name of the variable, used for error messages.
+ * @return The declared value.
+ * @throws std::runtime_error if the value is missing or the slot is already declared.
+ */
+Value Environment::declareSlot(int slot, Value value, const std::string& varname) {
+    if (value.isEmpty()) {
+        throw std::runtime_error("Cannot declare a variable with a null value");
+    }
+
+    if (!this->slots[slot].isEmpty()) {
+        throw std::runtime_error("Variable already declared: " + varname);
+    }
+
+    this->slots[slot] = value;
+    return value;
 }
 
-NativeFunctionValue::~NativeFunctionValue() {}
+/**
+ * Assign a statically resolved variable.
+ * Constness is checked by the caller, since the resolver already knows it.
+ *
+ * @param depth The number of parent environments to skip.
+ * @param slot The slot of the variable.
+ * @param value The value to assign.
+ * @param varname The name of the variable, used for error messages.
+ * @return The assigned value.
+ */
+Value Environment::assignSlot(int depth, int slot, Value value, const std::string& varname) {
+    Environment* env = this->ancestor(depth);
+    if (env->slots[slot].isEmpty()) {
+        throw std::runtime_error("Variable not found: " + varname);
+    }
+    env->slots[slot] = value;
+    return value;
+}
 
-FunctionValue::FunctionValue() {
-    type = VALUETYPE_FUNCTION;
+/**
+ * Look up a statically resolved variable.
+ *
+ * @param depth The number of parent environments to skip.
+ * @param slot The slot of the variable.
+ * @param varname The name of the variable, used for error messages.
+ * @return The value of the variable.
+ */
+Value Environment::lookupSlot(int depth, int slot, const std::string& varname) {
+    Value value = this->ancestor(depth)->slots[slot];
+    if (value.isEmpty()) {
+        throw std::runtime_error("Variable not found: " + varname);
+    }
+    return value;
 }
 
-FunctionValue::FunctionValue(std::string n) {
-    type = VALUETYPE_FUNCTION;
-    name = n;
+/**
+ * Mark the parent environment and every value held by this environment.
+ */
+void Environment::trace(Heap& heap) {
+    heap.markEnvironment(this->parent);
+    for (uint32_t i = 0; i < this->slotCount; i++) {
+        heap.markValue(this->slots[i]);
+    }
+    for (uint32_t i = 0; i < this->inlineBindingCount; i++) {
+        heap.markValue(this->inlineBindings[i].value);
+    }
+    if (this->table) {
+        this->table->forEach([&heap](const Binding& binding) { heap.markValue(binding.value); });
+    }
 }
 
-FunctionValue::FunctionValue(std::string n, std::vector<std::string> p) {
-    type = VALUETYPE_FUNCTION;
-    name = n;
-    parameters = p;
+// Slots that do not fit in the environment and the table of named variables
+size_t Environment::extraSize() const {
+    size_t size = (this->slotCount > INLINE_SLOTS) ? this->slotCount * sizeof(Value) : 0;
+    return this->table ? size + this->table->memorySize() : size;
 }
 
-FunctionValue::FunctionValue(std::string n, std::vector<std::string> p, Environment* env) {
-    type = VALUETYPE_FUNCTION;
-    name = n;
-    parameters = p;
-    declarationENV = env;
+NativeFunctionValue::NativeFunctionValue() {
+    type = VALUETYPE_NATIVE_FUNCTION;
+}
+
+NativeFunctionValue::NativeFunctionValue(FunctionCall call) {
+    type = VALUETYPE_NATIVE_FUNCTION;
+    this->call = call;
 }
 
-FunctionValue::FunctionValue(std::string n, std::vector<std::string> p, Environment* env, std::vector<Statement*> b) {
+NativeFunctionValue::~NativeFunctionValue() {}
+
+FunctionPrototype::FunctionPrototype(FunctionDeclaration* declaration, std::shared_ptr<AstArena> arena)
+    : arena(std::move(arena)),
+      declaration(declaration),
+      name(declaration->name),
+      parameters(declaration->parameters),
+      parameterSymbols(declaration->parameterSymbols),
+      body(declaration->body),
+      resolved(declaration->resolved),
+      frameSize(declaration->frameSize) {}
+
+FunctionValue::FunctionValue(std::shared_ptr<const FunctionPrototype> prototype, Environment* env)
+    : prototype(std::move(prototype)), declarationENV(env) {
     type = VALUETYPE_FUNCTION;
-    name = n;
-    parameters = p;
-    declarationENV = env;
-    body = b;
 }
 
 /**
  * Convert the function value to a string representation
  */
 void FunctionValue::toString() {
-    std::cout << "\n" << name << "(";
+    const std::vector<std::string>& parameters = prototype->parameters;
+    std::cout << "\n" << prototype->name << "(";
     for(int i = 0; i < parameters.size(); i++) {
         std::cout << parameters[i];
         if(i != parameters.size() - 1) {
@@ -193,19 +386,24 @@ void FunctionValue::toString() {
 
 FunctionValue::~FunctionValue() {}
 
-// Create a new RuntimeValue object by casting a NativeFunctionValue object
+// The function keeps the environment it was declared in alive
+void FunctionValue::trace(Heap& heap) {
+    heap.markEnvironment(this->declarationENV);
+}
+
+// Create a new value holding a NativeFunctionValue object
 // Parameters:
 // - call: FunctionCall object representing the function call
 // Returns:
-// - Pointer to the newly created RuntimeValue object
-RuntimeValue* MK_NATIVE_FUNCTION(FunctionCall call) {
-    return dynamic_cast<RuntimeValue*>(new NativeFunctionValue(call));
+// - Value pointing to the newly created NativeFunctionValue object
+Value MK_NATIVE_FUNCTION(FunctionCall call) {
+    return Value::object(heap().allocate<NativeFunctionValue>(call));
 }
 
-// This function takes a vector of RuntimeValue pointers and an Environment pointer as arguments
-// It returns a RuntimeValue pointer
-RuntimeValue* timeFunction(std::vector<RuntimeValue*> args, Environment* env){
-    // Return a new RuntimeValue pointer with the floor value of the current time
+// This function takes the call arguments and an Environment pointer
+// It returns a string value with the current time and date
+Value timeFunction(ArgumentSpan args, Environment* env){
+    // Return a new string value with the current time
 
     std::time_t currentTimeInSeconds = std::time(nullptr);
 
@@ -229,9 +427,39 @@ RuntimeValue* timeFunction(std::vector<RuntimeValue*> args, Environment* env){
     return MK_STRING(currentTime + " :: " + date);
 }
 
+// Math builtins, bound with defineNative
+static double square(double num) { return num * num; }
+static double cube(double num) { return num * num * num; }
+static double squareRoot(double num) { return std::sqrt(num); }
+static double roundNumber(double num) { return std::round(num); }
+static double sine(double num) { return std::sin(num); }
+static double cosine(double num) { return std::cos(num); }
+static double tangent(double num) { return std::tan(num); }
+
+// The factorial of the truncated argument, computed in doubles so that large
+// arguments give inf instead of overflowing; from 171 on the product is inf
+static double factorial(double value) {
+    double num = std::trunc(value);
+    double fact = 1;
+    for(double i = 2; i <= num && !std::isinf(fact); i++) {
+        fact *= i;
+    }
+    return fact;
+}
+
+// Random integer in [min, max], both bounds are truncated
+static double randomInteger(double minValue, double maxValue) {
+    int min = minValue;
+    int max = maxValue;
+    return std::rand() % (max - min + 1) + min;
+}
+
 // Function to create a global environment
 Environment* createGlobalEnv() {
-    Environment* env = new Environment();
+    Environment* env = heap().allocate<Environment>();
+
+    // The global environment lives as long as the interpreter
+    heap().addRoot(env);
 
     // Define global variables
     env->declareVariable("true", MK_BOOL(true), true);
@@ -240,23 +468,27 @@ Environment* createGlobalEnv() {
 
     // Define a native method for printing different types of values
     env->declareVariable("izpisi", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
+        [](ArgumentSpan args, Environment* env) -> Value {
             for (const auto& arg : args) {
-                if (!arg) {
-                    std::cout << "nullptr\n";
-                    continue;
-                }
-
-                if (arg->getTypeName() == "number") {
-                    dynamic_cast<NumberValue*>(arg)->toString();
-                } else if (arg->getTypeName() == "boolean") {
-                    dynamic_cast<BoolValue*>(arg)->toString();
-                } else if (arg->getTypeName() == "function") {
-                    dynamic_cast<FunctionValue*>(arg)->toString();
-                } else if (arg->getTypeName() == "string") {
-                    dynamic_cast<StringValue*>(arg)->toString();
-                } else if (arg->getTypeName() == "object") {
+                switch (arg.type()) {
+                case VALUETYPE_NUMBER:
+                    // Negative zero prints as 0, as it did when numbers were floats
+                    std::cout << (arg.asNumber() == 0.0 ? 0.0 : arg.asNumber());
+                    break;
+                case VALUETYPE_BOOLEAN:
+                    std::cout << std::boolalpha << arg.asBool() << std::endl;
+                    break;
+                case VALUETYPE_FUNCTION:
+                    static_cast<FunctionValue*>(arg.asObject())->toString();
+                    break;
+                case VALUETYPE_STRING:
+                    static_cast<StringValue*>(arg.asObject())->toString();
+                    break;
+                case VALUETYPE_OBJECT:
                     std::cout << "not implemented yet\n";
+                    break;
+                default:
+                    break;
                 }
             }
 
@@ -322,74 +554,16 @@ Environment* createGlobalEnv() {
 
     env->declareVariable("Pi", MK_NUMBER(3.1415926535897932384626433832795), true);
 
-    env->declareVariable("Kvadrat", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(num * num);
-        }
-    ), true);
-
-    env->declareVariable("Kub", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(num * num * num);
-        }
-    ), true);
-
-    env->declareVariable("Faktorial", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            int num = dynamic_cast<NumberValue*>(args[0])->value;
-            int fact = 1;
-            for(int i = 1; i <= num; i++) {
-                fact *= i;
-            }
-            return MK_NUMBER(fact);
-        }
-    ), true);
-
-    env->declareVariable("Koren", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(std::sqrt(num));
-        }
-    ), true);
-
-    env->declareVariable("NakljucnoStevilo", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            int min = dynamic_cast<NumberValue*>(args[0])->value;
-            int max = dynamic_cast<NumberValue*>(args[1])->value;
-            return MK_NUMBER(std::rand() % (max - min + 1) + min);
-        }
-    ), true);
-
-    env->declareVariable("Zaokrozi", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(std::round(num));
-        }
-    ), true);
-
-    env->declareVariable("Sin", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(std::sin(num));
-        }
-    ), true);
-
-    env->declareVariable("Cos", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-
-            return MK_NUMBER(std::cos(num));
-        }
-    ), true);
-
-    env->declareVariable("Tan", MK_NATIVE_FUNCTION(
-        [](std::vector<RuntimeValue*> args, Environment* env) -> RuntimeValue* {
-            float num = dynamic_cast<NumberValue*>(args[0])->value;
-            return MK_NUMBER(std::tan(num));
-        }
-    ), true);
+    // Math functions are bound from their C++ signatures, see native.h
+    defineNative<square>(env, "Kvadrat", true);
+    defineNative<cube>(env, "Kub", true);
+    defineNative<factorial>(env, "Faktorial", true);
+    defineNative<squareRoot>(env, "Koren", true);
+    defineNative<randomInteger>(env, "NakljucnoStevilo");
+    defineNative<roundNumber>(env, "Zaokrozi", true);
+    defineNative<sine>(env, "Sin", true);
+    defineNative<cosine>(env, "Cos", true);
+    defineNative<tangent>(env, "Tan", true);
 
     return env;
 }
\ No newline at end of file
@@ -4,69 +4,197 @@
 #include "values.h"
 #include "../frontend/ast.h"
 
-class Environment {
+// Imenovana spremenljivka v okolju
+// Simboli so gosta stevila, zato simbol sluzi tudi kot zgoscena vrednost
+struct Binding {
+    Symbol name = NO_SYMBOL;
+    Value value;
+    bool constant = false;
+};
+
+// Tabela imenovanih spremenljivk z odprtim naslavljanjem (linearno preizkusanje)
+// Uporabljena je sele, ko okolje preseze prostor za vgrajene spremenljivke
+class BindingTable {
+  private:
+    std::vector<Binding> entries = {};
+    std::vector<bool> used = {};
+    size_t count = 0;
+
+    void grow();
+
+  public:
+    Binding* find(Symbol name);
+    Binding* insert(Binding binding);
+
+    // Velikost tabele s pomnilnikom vnosov
+    size_t memorySize() const;
+
+    template <typename F> void forEach(F f) {
+        for (size_t i = 0; i < this->entries.size(); i++) {
+            if (this->used[i]) {
+                f(this->entries[i]);
+            }
+        }
+    }
+};
+
+class Environment : public GcObject {
   private:
+    // Stevilo spremenljivk, shranjenih neposredno v okolju
+    static constexpr size_t INLINE_SLOTS = 6;
+    static constexpr size_t INLINE_BINDINGS = 2;
+
     // Oetovski "environment" (slov. okolje)
-    Environment* parent;
-    
-    // Polje spremenljivk in njihovih vrednosti
-    std::map<std::string, RuntimeValue*> variables;
+    Environment* parent = nullptr;
+
+    // Reze staticno razresenih spremenljivk
+    // Prvih nekaj rez je v okolju, vecja okolja imajo rezi v locenem polju
+    Value* slots;
+    uint32_t slotCount = 0;
+    Value inlineSlots[INLINE_SLOTS];
+    std::unique_ptr<Value[]> overflowSlots;
+
+    // Imenovane spremenljivke, zastavica za konstanto je shranjena ob vrednosti
+    uint32_t inlineBindingCount = 0;
+    Binding inlineBindings[INLINE_BINDINGS];
+    std::unique_ptr<BindingTable> table;
+
+    // Poisce spremenljivko samo v tem okolju
+    Binding* findBinding(Symbol varname);
+
+    // Verzija imenovanih vezav in stevilo zivih okolij z imenovanimi vezavami
+    static uint64_t bindingVersion;
+    static size_t namedEnvironments;
 
-    // Polje konstant
-    std::set<std::string> constants;
   public:
     Environment();
     Environment(Environment* parentENV);
+    Environment(Environment* parentENV, size_t slotCount);
+    ~Environment();
+
+    // Okolja so pogosto ustvarjena in sproscena, zato jih hranimo v bazenu
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer);
 
     // Funkcija za preverjanje ali obstaja spremenljivka v okolju
-    bool hasVariable(const std::string& varname) const;
+    bool hasVariable(Symbol varname);
 
     // Funkcije za deklaracijo spremenljivke v okolju
-    RuntimeValue* declareVariable(const std::string& varname, RuntimeValue* value, bool constant);
+    // Razlicica z nizom ime internira (vgrajene funkcije)
+    Value declareVariable(Symbol varname, Value value, bool constant);
+    Value declareVariable(const std::string& varname, Value value, bool constant);
     
     // Funkcije za prireditev spremenljivke v okolju
-    RuntimeValue* assignVariable(const std::string& varname, RuntimeValue* value);
+    Value assignVariable(Symbol varname, Value value);
     
     // Funkcija za iskanje vrednosti spremenljivke v okolju
-    RuntimeValue* lookupVariable(const std::string& varname);
+    Value lookupVariable(Symbol varname);
+
+    // Poisce imenovano vezavo v verigi okolij, nullptr ce je ni
+    Binding* lookupBinding(Symbol varname);
+
+    // Verzija imenovanih vezav se poveca ob vsaki novi vezavi, ker lahko ta
+    // zakrije ali premakne obstojeco. Predpomnjena vezava je veljavna samo ob
+    // nespremenjeni verziji in le, ce imenovane vezave hrani eno samo okolje
+    // (globalno), saj tedaj vsaka veriga okolij najde isto vezavo.
+    static uint64_t getBindingVersion() { return bindingVersion; }
+    static bool bindingsCacheable() { return namedEnvironments <= 1; }
 
-    RuntimeValue* lookupOrMutateObject(MemberExpression* expr, RuntimeValue* value, Iden* property);
+    Value lookupOrMutateObject(MemberExpression* expr, Value value);
 
     // Funkcija za iskanje spremenljivke v okolju
-    Environment* resolve(std::string varname);
+    Environment* resolve(Symbol varname);
 
-    // Getter funkcija za polje spremenljivk
-    std::map<std::string, RuntimeValue*> getVariables();
+    // Starsevsko okolje
+    Environment* getParent() const;
+
+    // Okolje, ki je za depth starsev nad trenutnim
+    Environment* ancestor(int depth);
+
+    // Funkcije za staticno razresene spremenljivke
+    // Ime spremenljivke je uporabljeno le za sporocila o napakah
+    Value declareSlot(int slot, Value value, const std::string& varname);
+    Value assignSlot(int depth, int slot, Value value, const std::string& varname);
+    Value lookupSlot(int depth, int slot, const std::string& varname);
+
+    void trace(Heap& heap) override;
+    size_t extraSize() const override;
+};
+
+// Argumenti klica vgrajene funkcije: pogled na vrednosti, ki jih hrani klicoci
+// (medpomnilnik argumentov, registri ali sklad vrednosti), zato se ne kopirajo
+// Pogled je veljaven le med klicem, vrednosti v njem so koreni zbiralnika smeti
+class ArgumentSpan {
+  private:
+    const Value* values;
+    size_t count;
+
+  public:
+    constexpr ArgumentSpan(const Value* values, size_t count) : values(values), count(count) {}
+
+    size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+    const Value& operator[](size_t index) const { return this->values[index]; }
+    const Value* begin() const { return this->values; }
+    const Value* end() const { return this->values + this->count; }
 };
 
-// Define a type alias for a function that takes a vector of RuntimeValue pointers and an Environment pointer as arguments and returns a pointer to a RuntimeValue
-using FunctionCall = std::function<RuntimeValue*(std::vector<RuntimeValue*>, Environment*)>;
+// Vgrajena funkcija je navaden kazalec na funkcijo, brez std::function
+using FunctionCall = Value (*)(ArgumentSpan args, Environment* env);
 
 class NativeFunctionValue : public RuntimeValue {
   public:
     NativeFunctionValue();
     NativeFunctionValue(FunctionCall call);
     virtual ~NativeFunctionValue();
-    FunctionCall call;
+    FunctionCall call = nullptr;
+
+    // Cista funkcija je odvisna le od argumentov in nima stranskih ucinkov,
+    // zato jo lahko zlaganje konstant poklice ze pred izvajanjem
+    bool pure = false;
+
+    // Cista funkcija s podpisom double(double), ki jo strojna koda
+    // (runtime/jit.h) poklice neposredno, brez pakiranja argumentov
+    double (*unary)(double) = nullptr;
 };
 
+// Nespremenljiv prototip funkcije, skupen vsem zaprtjem iste deklaracije
+// Zgradi se ob prvi izvedbi deklaracije, deklaracija pa ga hrani le sibko,
+// zato prototip zivi, dokler obstaja katero od njegovih zaprtij
+class FunctionPrototype {
+  public:
+    FunctionPrototype(FunctionDeclaration* declaration, std::shared_ptr<AstArena> arena);
+
+    // Arena z vozlisci telesa funkcije, ki mora ziveti toliko casa kot prototip
+    const std::shared_ptr<AstArena> arena;
+
+    // Deklaracija, iz katere je funkcija nastala
+    FunctionDeclaration* const declaration;
+
+    const std::string& name;
+    const std::vector<std::string>& parameters;
+    const std::vector<Symbol>& parameterSymbols;
+    const std::vector<Statement*>& body;
+
+    // Ali so parametri razreseni v reze in koliko rez potrebuje okolje klica
+    const bool resolved;
+    const int frameSize;
+};
+
+// Zaprtje: prototip funkcije in okolje, v katerem je bila deklarirana
 class FunctionValue : public RuntimeValue {
   public:
-    FunctionValue();
-    FunctionValue(std::string n);
-    FunctionValue(std::string n, std::vector<std::string> p);
-    FunctionValue(std::string n, std::vector<std::string> p, Environment* env);
-    FunctionValue(std::string n, std::vector<std::string> p, Environment* env, std::vector<Statement*> b);
+    FunctionValue(std::shared_ptr<const FunctionPrototype> prototype, Environment* env);
     virtual ~FunctionValue();
-    std::string name = "";
-    std::vector<std::string> parameters = {};
-    Environment* declarationENV;
-    std::vector<Statement*> body = {};
+
+    std::shared_ptr<const FunctionPrototype> prototype;
+    Environment* declarationENV = nullptr;
 
     void toString();
+    void trace(Heap& heap) override;
 };
 
 Environment* createGlobalEnv();
-RuntimeValue* MK_NATIVE_FUNCTION(FunctionCall call);
+Value MK_NATIVE_FUNCTION(FunctionCall call);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "gc.h"
+#include "environment.h"
+
+// Heap sizes are rounded so small programs never collect
+static const size_t MIN_COLLECTION_THRESHOLD = 1024 * 1024;
+
+Heap& heap() {
+    static Heap instance;
+    return instance;
+}
+
+Heap::~Heap() {
+    while (this->objects != nullptr) {
+        GcObject* next = this->objects->gcNext;
+        delete this->objects;
+        this->objects = next;
+    }
+}
+
+/**
+ * Prepare for an allocation: collect if the heap has grown past the
+ * threshold and check the heap limit.
+ *
+ * @param size The size of the object about to be allocated.
+ * @throws std::runtime_error if the heap limit would be exceeded.
+ */
+void Heap::beforeAllocation(size_t size) {
+    if (this->stress || this->bytesAllocated + size > this->nextCollection) {
+        this->collect();
+    }
+    if (this->limit != 0 && this->bytesAllocated + size > this->limit) {
+        throw std::runtime_error("Heap limit exceeded: " + std::to_string(this->limit) + " bytes.");
+    }
+}
+
+/**
+ * Link a new object into the heap and charge its size, including the
+ * memory it owns outside itself. The limit is checked again here, since
+ * that memory is only known once the object is constructed; the new
+ * object is kept alive by a root during the collection.
+ *
+ * @param object The new object.
+ * @param size The size of the object itself.
+ * @throws std::runtime_error if the heap limit is exceeded.
+ */
+void Heap::track(GcObject* object, size_t size) {
+    size += object->extraSize();
+    object->gcSize = (uint32_t)size;
+    object->gcNext = this->objects;
+    this->objects = object;
+    this->bytesAllocated += size;
+    this->stats.peakBytes = std::max(this->stats.peakBytes, this->bytesAllocated);
+
+    if (this->limit != 0 && this->bytesAllocated > this->limit) {
+        Root root(object);
+        this->collect();
+        if (this->bytesAllocated > this->limit) {
+            throw std::runtime_error("Heap limit exceeded: " + std::to_string(this->limit) + " bytes.");
+        }
+    }
+}
+
+/**
+ * Charge the change in the memory an object owns outside itself.
+ *
+ * @param object The object whose buffers changed.
+ * @param before The object's extraSize() before the change.
+ * @throws std::runtime_error if the heap limit is exceeded.
+ */
+void Heap::resize(GcObject* object, size_t before) {
+    size_t after = object->extraSize();
+    object->gcSize = (uint32_t)(object->gcSize + after - before);
+    this->bytesAllocated += after - before;
+    this->stats.peakBytes = std::max(this->stats.peakBytes, this->bytesAllocated);
+
+    if (this->limit != 0 && this->bytesAllocated > this->limit) {
+        throw std::runtime_error("Heap limit exceeded: " + std::to_string(this->limit) + " bytes.");
+    }
+}
+
+void Heap::markObject(GcObject* object) {
+    if (object == nullptr || object->gcMarked) {
+        return;
+    }
+    object->gcMarked = true;
+    this->grayStack.push_back(object);
+}
+
+void Heap::markValue(Value value) {
+    if (value.isObject()) {
+        this->markObject(value.asObject());
+    }
+}
+
+void Heap::markValues(const std::vector<Value>& values) {
+    for (const Value& value : values) {
+        this->markValue(value);
+    }
+}
+
+void Heap::markEnvironment(Environment* env) {
+    this->markObject(env);
+}
+
+void Heap::markRoots() {
+    for (GcObject* object : this->persistentRoots) {
+        this->markObject(object);
+    }
+    for (const std::vector<Value>* values : this->persistentValueRoots) {
+        this->markValues(*values);
+    }
+    for (const RootEntry& entry : this->shadowStack) {
+        switch (entry.kind) {
+        case RootEntry::VALUE:
+            this->markValue(*static_cast<Value*>(entry.pointer));
+            break;
+        case RootEntry::VALUES:
+            this->markValues(*static_cast<std::vector<Value>*>(entry.pointer));
+            break;
+        case RootEntry::OBJECT:
+            this->markObject(static_cast<GcObject*>(entry.pointer));
+            break;
+        case RootEntry::ENVIRONMENT:
+            this->markObject(*static_cast<Environment**>(entry.pointer));
+            break;
+        case RootEntry::CALLBACK:
+            entry.trace(entry.pointer, *this);
+            break;
+        }
+    }
+}
+
+/**
+ * Free every object that was not marked and clear the marks of the rest.
+ */
+void Heap::sweep() {
+    GcObject** link = &this->objects;
+    while (*link != nullptr) {
+        GcObject* object = *link;
+        if (object->gcMarked) {
+            object->gcMarked = false;
+            link = &object->gcNext;
+            continue;
+        }
+        *link = object->gcNext;
+        this->bytesAllocated -= object->gcSize;
+        this->stats.bytesFreed += object->gcSize;
+        this->stats.objectsFreed++;
+        delete object;
+    }
+}
+
+/**
+ * Run a full mark-sweep collection.
+ * Marking uses an explicit gray stack, so deeply nested objects
+ * and long environment chains do not overflow the C++ stack.
+ */
+void Heap::collect() {
+    auto start = std::chrono::steady_clock::now();
+
+    this->markRoots();
+    while (!this->grayStack.empty()) {
+        GcObject* object = this->grayStack.back();
+        this->grayStack.pop_back();
+        object->trace(*this);
+    }
+    this->sweep();
+
+    this->nextCollection = std::max(MIN_COLLECTION_THRESHOLD, this->bytesAllocated * 2);
+    if (this->limit != 0) {
+        this->nextCollection = std::min(this->nextCollection, this->limit);
+    }
+
+    double pause = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    this->stats.collections++;
+    this->stats.totalPauseMs += pause;
+    this->stats.maxPauseMs = std::max(this->stats.maxPauseMs, pause);
+}
+
+void Heap::addRoot(GcObject* object) {
+    this->persistentRoots.push_back(object);
+}
+
+void Heap::addRoots(const std::vector<Value>* values) {
+    this->persistentValueRoots.push_back(values);
+}
+
+void Heap::removeRoots(const std::vector<Value>* values) {
+    auto it = std::find(this->persistentValueRoots.begin(), this->persistentValueRoots.end(), values);
+    if (it != this->persistentValueRoots.end()) {
+        this->persistentValueRoots.erase(it);
+    }
+}
+
+void Heap::setLimit(size_t bytes) {
+    this->limit = bytes;
+    if (this->limit != 0) {
+        this->nextCollection = std::min(this->nextCollection, this->limit);
+    }
+}
+
+void Heap::setStress(bool enabled) {
+    this->stress = enabled;
+}
+
+GcStats Heap::getStats() const {
+    GcStats current = this->stats;
+    current.liveBytes = this->bytesAllocated;
+    return current;
+}
+
+void Heap::printStats(std::ostream& out) const {
+    GcStats stats = this->getStats();
+    out << "GC: " << stats.collections << " zbiranj, "
+        << stats.objectsFreed << " sproscenih objektov (" << stats.bytesFreed << " B), "
+        << "ziva kopica " << stats.liveBytes << " B, najvec " << stats.peakBytes << " B, "
+        << "premor skupaj " << stats.totalPauseMs << " ms, najdaljsi " << stats.maxPauseMs << " ms" << std::endl;
+}
@@ -0,0 +1,143 @@
+#ifndef GC_H
+#define GC_H
+
+#include "../frontend/Functions.h"
+
+#include <cstdint>
+
+class Heap;
+class Value;
+class Environment;
+
+// Objekt, ki ga upravlja zbiralnik smeti
+// Vsi objekti na kopici so povezani v seznam, po katerem se sprehodi pometanje
+class GcObject {
+  public:
+    virtual ~GcObject() = default;
+
+    // Oznaci vse objekte, na katere kaze ta objekt
+    virtual void trace(Heap&) {}
+
+    // Pomnilnik zunaj objekta, ki ga objekt poseduje (tabele rez, vsebina nizov)
+    // Steje se v velikost kopice; ko se spremeni, lastnik poklice Heap::resize
+    virtual size_t extraSize() const { return 0; }
+
+  private:
+    friend class Heap;
+    GcObject* gcNext = nullptr;
+    uint32_t gcSize = 0;
+    bool gcMarked = false;
+};
+
+// Statistika zbiralnika smeti
+struct GcStats {
+    size_t collections = 0;
+    size_t objectsFreed = 0;
+    size_t bytesFreed = 0;
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    double totalPauseMs = 0.0;
+    double maxPauseMs = 0.0;
+};
+
+// Kopica z natancnim zbiralnikom smeti (oznaci in pometi)
+// Koreni so trajni (globalno okolje, konstante prevedene kode)
+// ali zacasni na sencnem skladu (vmesne vrednosti interpreterja)
+class Heap {
+  public:
+    // Zacasni koren na sencnem skladu
+    struct RootEntry {
+        enum Kind { VALUE, VALUES, OBJECT, ENVIRONMENT, CALLBACK } kind;
+        void* pointer;
+        void (*trace)(void* pointer, Heap& heap);
+    };
+
+  private:
+    // Vsi zivi in se ne pometeni objekti
+    GcObject* objects = nullptr;
+
+    // Velikost vseh objektov na kopici
+    size_t bytesAllocated = 0;
+
+    // Pri tej velikosti kopice se sprozi naslednje zbiranje
+    size_t nextCollection = 1024 * 1024;
+
+    // Najvecja dovoljena velikost kopice (0 pomeni brez omejitve)
+    size_t limit = 0;
+
+    // Zbiranje ob vsaki alokaciji
+    bool stress = false;
+
+    std::vector<GcObject*> persistentRoots = {};
+    std::vector<const std::vector<Value>*> persistentValueRoots = {};
+    std::vector<RootEntry> shadowStack = {};
+
+    // Oznaceni objekti, katerih otroci se niso oznaceni
+    std::vector<GcObject*> grayStack = {};
+
+    GcStats stats;
+
+    void beforeAllocation(size_t size);
+    void track(GcObject* object, size_t size);
+    void markRoots();
+    void sweep();
+
+  public:
+    Heap() = default;
+    ~Heap();
+
+    Heap(const Heap&) = delete;
+    Heap& operator=(const Heap&) = delete;
+
+    // Ustvari objekt na kopici, pred tem lahko sprozi zbiranje
+    template <typename T, typename... Args> T* allocate(Args&&... args) {
+        this->beforeAllocation(sizeof(T));
+        T* object = new T(std::forward<Args>(args)...);
+        this->track(object, sizeof(T));
+        return object;
+    }
+
+    void collect();
+
+    // Objekt je spremenil velikost svojega pomnilnika, before je extraSize() pred spremembo
+    // Ne sprozi zbiranja, ker klicoci vmesnih vrednosti nimajo nujno med koreni
+    void resize(GcObject* object, size_t before);
+
+    void markObject(GcObject* object);
+    void markValue(Value value);
+    void markValues(const std::vector<Value>& values);
+    void markEnvironment(Environment* env);
+
+    // Trajni koreni
+    void addRoot(GcObject* object);
+    void addRoots(const std::vector<Value>* values);
+    void removeRoots(const std::vector<Value>* values);
+
+    // Sencni sklad, uporablja ga razred Root
+    void pushRoot(RootEntry entry) { this->shadowStack.push_back(entry); }
+    void popRoot() { this->shadowStack.pop_back(); }
+
+    void setLimit(size_t bytes);
+    void setStress(bool enabled);
+    GcStats getStats() const;
+    void printStats(std::ostream& out) const;
+};
+
+// Kopica, ki jo uporablja interpreter
+Heap& heap();
+
+// Zacasni koren, ki je veljaven do konca bloka
+class Root {
+  public:
+    Root(Value& value) { heap().pushRoot({Heap::RootEntry::VALUE, &value, nullptr}); }
+    Root(std::vector<Value>& values) { heap().pushRoot({Heap::RootEntry::VALUES, &values, nullptr}); }
+    Root(GcObject* object) { heap().pushRoot({Heap::RootEntry::OBJECT, object, nullptr}); }
+    Root(Environment*& env) { heap().pushRoot({Heap::RootEntry::ENVIRONMENT, &env, nullptr}); }
+    Root(void* pointer, void (*trace)(void*, Heap&)) { heap().pushRoot({Heap::RootEntry::CALLBACK, pointer, trace}); }
+    ~Root() { heap().popRoot(); }
+
+    Root(const Root&) = delete;
+    Root& operator=(const Root&) = delete;
+};
+
+#endif
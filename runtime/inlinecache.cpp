@@ -0,0 +1,73 @@
+#include "inlinecache.h"
+#include "interpreter.h"
+
+/**
+ * Find the binding of a name, through the cache of the identifier if it is valid.
+ *
+ * @param iden The identifier, which holds the cache.
+ * @param env The environment the lookup starts in.
+ * @return The binding.
+ * @throws std::runtime_error if the variable is not declared.
+ */
+static Binding* findNameCached(Iden* iden, Environment* env) {
+    if (iden->cachedVersion == Environment::getBindingVersion()) {
+        runtimeStats().nameHits++;
+        return iden->cachedBinding;
+    }
+
+    runtimeStats().nameMisses++;
+    Binding* binding = env->lookupBinding(iden->symbol);
+    if (binding == nullptr) {
+        throw std::runtime_error("Variable not found: " + iden->value);
+    }
+    if (Environment::bindingsCacheable()) {
+        iden->cachedBinding = binding;
+        iden->cachedVersion = Environment::getBindingVersion();
+    }
+    return binding;
+}
+
+Value lookupNameCached(Iden* iden, Environment* env) {
+    return findNameCached(iden, env)->value;
+}
+
+Value assignNameCached(Iden* iden, Environment* env, Value value) {
+    Binding* binding = findNameCached(iden, env);
+    if (binding->constant) {
+        throw std::runtime_error("Cannot modify constant variable: " + iden->value);
+    }
+    binding->value = value;
+    return value;
+}
+
+/**
+ * Read a named property. The cache holds the shape of the last object that
+ * had the property and the slot it is in, which is the same for every object
+ * of that shape.
+ *
+ * @param member The member expression, which holds the cache.
+ * @param object The object whose property is read.
+ * @return The value of the property, or null if the object does not have it.
+ * @throws std::runtime_error if the value is not an object.
+ */
+Value getPropertyCached(MemberExpression* member, Value object) {
+    Symbol key = static_cast<Iden*>(member->property)->symbol;
+    if (!object.isObjectOf(VALUETYPE_OBJECT)) {
+        return getProperty(object, key);
+    }
+
+    ObjectValue* obj = static_cast<ObjectValue*>(object.asObject());
+    if (obj->getShape() == member->cachedShape) {
+        runtimeStats().propertyHits++;
+        return obj->getSlot(member->cachedSlot);
+    }
+
+    runtimeStats().propertyMisses++;
+    int slot = obj->getShape()->lookup(key);
+    if (slot < 0) {
+        return MK_NULL();
+    }
+    member->cachedShape = obj->getShape();
+    member->cachedSlot = (uint32_t)slot;
+    return obj->getSlot(slot);
+}
@@ -0,0 +1,22 @@
+#ifndef INLINECACHE_H
+#define INLINECACHE_H
+
+#include "environment.h"
+#include "stats.h"
+
+// Monomorfni predpomnilniki v vozliscih AST
+// Iden hrani vezavo spremenljivke, ki se isce po imenu, skupaj z verzijo vezav.
+// MemberExpression hrani obliko objekta in rezo lastnosti v njej.
+// Ob zgresitvi se uporabi pocasna pot, ki predpomnilnik ponovno napolni.
+// Uporabljajo jih drevesni interpreter, evalvator s skladom in navidezni stroj.
+
+// Vrednost spremenljivke, ki se isce po imenu
+Value lookupNameCached(Iden* iden, Environment* env);
+
+// Prireditev spremenljivki, ki se isce po imenu
+Value assignNameCached(Iden* iden, Environment* env, Value value);
+
+// Branje lastnosti obj.kljuc (ne izracunanega kljuca)
+Value getPropertyCached(MemberExpression* member, Value object);
+
+#endif
@@ -1,6 +1,10 @@
 #include "interpreter.h"
+#include "tiering.h"
 #include <cmath>
 
+// Arena of the program that is currently being evaluated
+static std::shared_ptr<AstArena> activeArena;
+
 /**
  * Evaluates a variable declaration and declares the variable in the environment.
  * 
@@ -8,8 +12,39 @@
  * @param env The environment in which to declare the variable.
  * @return The runtime value of the variable.
  */
-RuntimeValue* evaluateVariableDeclaration(VariableDeclaration* declaration, Environment* env) {
-    return env->declareVariable(declaration->identifier, evaluate(declaration->expressionValue, env), declaration->constant);
+Value evaluateVariableDeclaration(VariableDeclaration* declaration, Environment* env) {
+    Value value = evaluate(declaration->expressionValue, env);
+    if(declaration->slot >= 0) {
+        return env->declareSlot(declaration->slot, value, declaration->identifier);
+    }
+    return env->declareVariable(declaration->symbol, value, declaration->constant);
+}
+
+/*
+ * Create a function value for a declaration and declare it in the environment.
+ * 
+ * @param declaration The function declaration.
+ * @param env The environment in which to declare the function.
+ * @param arena The arena holding the declaration's body.
+ * @return The runtime value of the function.
+ */
+Value declareFunction(FunctionDeclaration* declaration, Environment* env, const std::shared_ptr<AstArena>& arena) {
+    // All closures of a declaration share one prototype. The function outlives the program
+    // it was declared in (e.g. across REPL lines), so the prototype keeps the arena alive
+    std::shared_ptr<FunctionPrototype> prototype = declaration->prototype.lock();
+    if(!prototype) {
+        prototype = std::make_shared<FunctionPrototype>(declaration, arena);
+        declaration->prototype = prototype;
+    }
+
+    // The closure is only the prototype and the current environment
+    FunctionValue* func = heap().allocate<FunctionValue>(std::move(prototype), env);
+
+    // Declare the function as a constant in the current environment
+    if(declaration->slot >= 0) {
+        return env->declareSlot(declaration->slot, Value::object(func), declaration->name);
+    }
+    return env->declareVariable(declaration->nameSymbol, Value::object(func), true);
 }
 
 /*
@@ -19,17 +54,8 @@ RuntimeValue* evaluateVariableDeclaration(VariableDeclaration* declaration, Envi
  * @param env The environment in which to declare the function.
  * @return The runtime value of the function.
  */
-RuntimeValue* evaluateFunctionDeclaration(FunctionDeclaration* declaration, Environment* env) {
-    // Create a new function value
-    FunctionValue* func = new FunctionValue(
-        declaration->name,  // name of the function
-        declaration->parameters,  // parameters of the function
-        env,  // current environment
-        declaration->body  // body of the function
-    );
-
-    // Declare the function as a variable in the current environment
-    return env->declareVariable(declaration->name, dynamic_cast<RuntimeValue*>(func), true);
+Value evaluateFunctionDeclaration(FunctionDeclaration* declaration, Environment* env) {
+    return declareFunction(declaration, env, activeArena);
 }
 
 /*
@@ -39,11 +65,16 @@ RuntimeValue* evaluateFunctionDeclaration(FunctionDeclaration* declaration, Envi
  * @param env The environment in which to evaluate the program
  * @return The last evaluated runtime value
 */
-RuntimeValue* evaluateProgram(Program* program, Environment* env) {
-    RuntimeValue* lastEvaluated = MK_NULL();
+Value evaluateProgram(Program* program, Environment* env) {
+    std::shared_ptr<AstArena> previousArena = activeArena;
+    activeArena = program->arena;
+
+    Value lastEvaluated = MK_NULL();
     for(auto stmt : program->body) {
         lastEvaluated = evaluate(stmt, env);
     }
+
+    activeArena = previousArena;
     return lastEvaluated;
 }
 
@@ -52,44 +83,54 @@ RuntimeValue* evaluateProgram(Program* program, Environment* env) {
  * 
  * @param left The left operand
  * @param right The right operand
- * @param op The operator
+ * @param op The operator, resolved by the parser
  * @return The result of the binary expression
  */
-RuntimeValue* evaluateNumericBinaryExpression(RuntimeValue* left, RuntimeValue* right, std::string op) {
-    if(op == "!=") {
-        return equals(left, right, false);
-    } else if(op == "==") {
-        return equals(left, right, true);
-    } else if(op == "<=") {
-        return compare(left, right, true);
-    } else if(op == ">=") {
-        return compare(left, right, false);
-    } else if(left->type == VALUETYPE_NUMBER && right->type == VALUETYPE_NUMBER) {
-        NumberValue* l = dynamic_cast<NumberValue*>(left);
-        NumberValue* r = dynamic_cast<NumberValue*>(right);
-        float result = 0.0;
-        if(op == "+") {
-            result = l->value + r->value;
-        } else if(op == "-") {
-            result = l->value - r->value;
-        } else if(op == "*") {
-            result = l->value * r->value;
-        } else if(op == "/") {
-            if(r->value == 0.0) {
+Value evaluateNumericBinaryExpression(Value left, Value right, OperatorType op) {
+    switch(op) {
+        case OP_NOT_EQUALS:
+            return equals(left, right, false);
+        case OP_EQUALS:
+            return equals(left, right, true);
+        case OP_LESS_EQUALS:
+            return compare(left, right, true);
+        case OP_GREATER_EQUALS:
+            return compare(left, right, false);
+        default:
+            break;
+    }
+
+    if(!left.isNumber() || !right.isNumber()) {
+        return MK_NULL();
+    }
+
+    double l = left.asNumber();
+    double r = right.asNumber();
+
+    switch(op) {
+        case OP_ADD:
+            return MK_NUMBER(l + r);
+        case OP_SUBTRACT:
+            return MK_NUMBER(l - r);
+        case OP_MULTIPLY:
+            return MK_NUMBER(l * r);
+        case OP_DIVIDE:
+            if(r == 0.0) {
                 throw std::runtime_error("Deljenje z 0.");
-            } else {
-                result = l->value / r->value;
             }
-        } else if(op == "%") {
-            if(r->value == 0.0) {
+            return MK_NUMBER(l / r);
+        case OP_MODULO:
+            if(r == 0.0) {
                 throw std::runtime_error("Modulo z 0.");
-            } else {
-                result = fmod(l->value, r->value);
             }
-        }
-        return MK_NUMBER(result);
+            return MK_NUMBER(fmod(l, r));
+        case OP_LESS:
+            return MK_BOOL(l < r);
+        case OP_GREATER:
+            return MK_BOOL(l > r);
+        default:
+            return MK_NULL();
     }
-    return MK_NULL();
 }
 
 template <typename T>
@@ -130,23 +171,27 @@ bool isComparisonTrue(T lhs, T rhs, bool strict) {
 }
 
 /*
- * This function compares two RuntimeValues and returns the result
+ * This function compares two values and returns the result
  * 
- * @param lhs The left-hand side RuntimeValue
- * @param rhs The right-hand side RuntimeValue
+ * @param lhs The left-hand side value
+ * @param rhs The right-hand side value
  * @param strict A boolean indicating whether the comparison should be strict
- * @return A RuntimeValue representing the result of the comparison
+ * @return A value representing the result of the comparison
  */
-RuntimeValue* compare(RuntimeValue* lhs, RuntimeValue* rhs, bool strict) {
-    switch (lhs->type) {
+Value compare(Value lhs, Value rhs, bool strict) {
+    ValueType type = lhs.type();
+    if (rhs.type() != type) {
+        return MK_NULL();
+    }
+    switch (type) {
         case VALUETYPE_BOOLEAN:
-            return MK_BOOL(isComparisonTrue(dynamic_cast<BoolValue*>(lhs)->value, dynamic_cast<BoolValue*>(rhs)->value, strict));
+            return MK_BOOL(isComparisonTrue(lhs.asBool(), rhs.asBool(), strict));
         case VALUETYPE_NUMBER:
-            return MK_BOOL(isComparisonTrue(dynamic_cast<NumberValue*>(lhs)->value, dynamic_cast<NumberValue*>(rhs)->value, strict));
+            return MK_BOOL(isComparisonTrue(lhs.asNumber(), rhs.asNumber(), strict));
         case VALUETYPE_FUNCTION:
-            return MK_BOOL(isComparisonTrue(dynamic_cast<FunctionValue*>(lhs)->body, dynamic_cast<FunctionValue*>(rhs)->body, strict));
+            return MK_BOOL(isComparisonTrue(static_cast<FunctionValue*>(lhs.asObject())->prototype->body, static_cast<FunctionValue*>(rhs.asObject())->prototype->body, strict));
         case VALUETYPE_NULL:
-            return MK_BOOL(isComparisonTrue(dynamic_cast<NullValue*>(lhs)->value, dynamic_cast<NullValue*>(rhs)->value, strict));
+            return MK_BOOL(true);
         default:
             throw std::runtime_error("Unhandeled type in equals function.");
     }
@@ -197,23 +242,32 @@ bool compareEquality(T lhs, T rhs, bool strict) {
  * @param strict - Whether to use strict comparison
  * @return A boolean runtime value indicating the result of the comparison
  */
-RuntimeValue* equals(RuntimeValue* lhs, RuntimeValue* rhs, bool strict) {
-    switch (lhs->type) {
+Value equals(Value lhs, Value rhs, bool strict) {
+    ValueType type = lhs.type();
+    // Values of different types are never equal
+    if (rhs.type() != type) {
+        return MK_BOOL(!strict);
+    }
+    switch (type) {
         // Compare equality for boolean values
         case VALUETYPE_BOOLEAN:
-            return MK_BOOL(compareEquality(dynamic_cast<BoolValue*>(lhs)->value, dynamic_cast<BoolValue*>(rhs)->value, strict));
+            return MK_BOOL(compareEquality(lhs.asBool(), rhs.asBool(), strict));
 
         // Compare equality for number values
         case VALUETYPE_NUMBER:
-            return MK_BOOL(compareEquality(dynamic_cast<NumberValue*>(lhs)->value, dynamic_cast<NumberValue*>(rhs)->value, strict));
+            return MK_BOOL(compareEquality(lhs.asNumber(), rhs.asNumber(), strict));
+
+        // Compare equality for string values
+        case VALUETYPE_STRING:
+            return MK_BOOL(compareEquality(stringsEqual(lhs, rhs), true, strict));
 
         // Compare equality for function values
         case VALUETYPE_FUNCTION:
-            return MK_BOOL(compareEquality(dynamic_cast<FunctionValue*>(lhs)->body, dynamic_cast<FunctionValue*>(rhs)->body, strict));
+            return MK_BOOL(compareEquality(static_cast<FunctionValue*>(lhs.asObject())->prototype->body, static_cast<FunctionValue*>(rhs.asObject())->prototype->body, strict));
 
-        // Compare equality for null values
+        // Null is always equal to null
         case VALUETYPE_NULL:
-            return MK_BOOL(compareEquality(dynamic_cast<NullValue*>(lhs)->value, dynamic_cast<NullValue*>(rhs)->value, strict));
+            return MK_BOOL(strict);
 
         // Throw an error for unhandled value types
         default:
@@ -231,84 +285,240 @@ RuntimeValue* equals(RuntimeValue* lhs, RuntimeValue* rhs, bool strict) {
  * @param env The environment in which to evaluate the identifier
  * @return The runtime value of the identifier
  */
-RuntimeValue* evaluateIdentifier(Iden* iden, Environment* env) {
-    RuntimeValue* val = env->lookupVariable(iden->value);
-    return val;
+Value evaluateIdentifier(Iden* iden, Environment* env) {
+    if(iden->depth >= 0) {
+        return env->lookupSlot(iden->depth, iden->slot, iden->value);
+    }
+    return lookupNameCached(iden, env);
 }
 
 /*
- * Evaluate an object literal and return a RuntimeValue
+ * Evaluate an object literal and return its value
  *
  * @param obj The object literal to evaluate
  * @param env The current environment
  * @return The runtime value of the object
  */
-RuntimeValue* evaluateObject(ObjectLiteral* obj, Environment* env) {
-    // Create a new ObjectValue
-    ObjectValue* object = new ObjectValue();
+Value evaluateObject(ObjectLiteral* obj, Environment* env) {
+    // Create a new ObjectValue with the shape shared by all objects of this literal
+    ObjectValue* object = heap().allocate<ObjectValue>(literalShape(obj));
+    Root objectRoot(object);
 
     // Iterate through each property of the object
     for(auto prop : obj->properties) {
         // Evaluate the property value or look it up in the current environment
-        RuntimeValue* runtimeValue = (prop->value == nullptr) ? env->lookupVariable(prop->key) : evaluate(prop->value, env);
+        Value runtimeValue = (prop->value == nullptr) ? env->lookupVariable(prop->symbol) : evaluate(prop->value, env);
+
+        // Store the evaluated value in the slot of the property
+        object->setSlot(prop->slot, runtimeValue);
+    }
+
+    // Return the object as a value
+    return Value::object(object);
+}
+
+/*
+ * Create the environment of a call and bind the arguments to the parameters.
+ *
+ * @param func The function being called
+ * @param args The evaluated arguments
+ * @param argc The number of arguments
+ * @return The environment in which the function body runs
+ */
+Environment* bindArguments(FunctionValue* func, const Value* args, size_t argc) {
+    const FunctionPrototype& prototype = *func->prototype;
+    Environment* scope = heap().allocate<Environment>(func->declarationENV, prototype.frameSize); // Create a new environment for the function scope
+
+    for(size_t i = 0; i < prototype.parameters.size(); i++) {
+        // Missing arguments are bound to null
+        Value arg = (i < argc) ? args[i] : MK_NULL();
+        // Declare function parameters in the function scope, resolved parameters occupy the first slots
+        if(prototype.resolved) {
+            scope->declareSlot(i, arg, prototype.parameters[i]);
+        } else {
+            scope->declareVariable(prototype.parameterSymbols[i], arg, false);
+        }
+    }
+
+    return scope;
+}
+
+/*
+ * Evaluate a function body up to a call in tail position.
+ * If statements in tail position are evaluated here as well, so that
+ * a tail call inside a branch is found.
+ *
+ * @param body The statements to evaluate
+ * @param env The environment of the body, updated to the environment of the taken branch
+ * @param result Receives the value of the body if it does not end with a tail call
+ * @return The tail call that is left to evaluate, or nullptr
+ */
+static CallExpression* evaluateUntilTailCall(const std::vector<Statement*>& body, Environment*& env, Value& result) {
+    if(body.empty()) {
+        result = MK_NULL();
+        return nullptr;
+    }
+    for(size_t i = 0; i + 1 < body.size(); i++) {
+        evaluate(body[i], env);
+    }
 
-        // Assign the evaluated value to the property in the object
-        object->properties[prop->key] = runtimeValue;
+    Statement* last = body.back();
+    if(last->getKind() == NODE_CALLEXPRESSION && static_cast<CallExpression*>(last)->tail) {
+        return static_cast<CallExpression*>(last);
+    }
+    if(last->getKind() == NODE_IFEXPRESSION) {
+        // Same semantics as evaluateIfStatement
+        IfStatement* ifStmt = static_cast<IfStatement*>(last);
+        Value test = evaluate(ifStmt->test, env);
+        if(!test.isBool()) {
+            result = MK_NULL();
+            return nullptr;
+        }
+        if(test.asBool()) {
+            env = heap().allocate<Environment>(env, ifStmt->bodyFrameSize);
+            return evaluateUntilTailCall(ifStmt->body, env, result);
+        }
+        env = heap().allocate<Environment>(env, ifStmt->alternateFrameSize);
+        return evaluateUntilTailCall(ifStmt->alternate, env, result);
     }
 
-    // Return the object as a RuntimeValue
-    return dynamic_cast<RuntimeValue*>(object);
+    result = evaluate(last, env);
+    return nullptr;
 }
 
 /*
- * Evaluate a call expression
+ * The argument buffer shared by all calls of the tree-walker and the
+ * closure engine. A call pushes its arguments and callee on top and drops
+ * them when it returns, so calls reuse the buffer's capacity instead of
+ * allocating a vector each. Everything in the buffer is a root.
+ */
+std::vector<Value>& argumentBuffer() {
+    static std::vector<Value>* buffer = [] {
+        std::vector<Value>* values = new std::vector<Value>();
+        heap().addRoots(values);
+        return values;
+    }();
+    return *buffer;
+}
+
+/*
+ * Call a user function with already evaluated arguments.
+ * Calls in tail position reuse this call instead of recursing,
+ * so tail-recursive functions run in constant stack space.
+ *
+ * @param func The function to call
+ * @param args The evaluated arguments, only read before the body starts running
+ * @param argc The number of arguments
+ * @return The value of the last statement of the function body
+ */
+Value callFunction(FunctionValue* func, const Value* args, size_t argc) {
+    if(tierSettings().enabled && countCall(func)) {
+        return callHot(func, args, argc);
+    }
+
+    // The running function and the innermost environment stay alive while the body runs
+    Value function = Value::object(func);
+    Root functionRoot(function);
+    Environment* env = bindArguments(func, args, argc);
+    Root envRoot(env);
+
+    ArgumentFrame frame;
+    while(true) {
+        Value result = MK_NULL();
+        CallExpression* tailCall = evaluateUntilTailCall(func->prototype->body, env, result);
+        if(tailCall == nullptr) {
+            return result;
+        }
+
+        frame.clear();
+        for(auto arg : tailCall->args) {
+            frame.push(evaluate(arg, env));
+        }
+        Value callee = evaluate(tailCall->caller, env);
+        if(callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            function = callee;
+            func = static_cast<FunctionValue*>(callee.asObject());
+            if(tierSettings().enabled && countCall(func)) {
+                return callHot(func, frame.data(), frame.size());
+            }
+            env = bindArguments(func, frame.data(), frame.size());
+            continue;
+        }
+        if(callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            return static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(frame.data(), frame.size()), env);
+        }
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    }
+}
+
+/*
+ * Evaluate a call expression. The callee is evaluated once, after the arguments.
  *
  * @param expr The call expression to evaluate
  * @param env The environment in which to evaluate the call expression
  * @return The runtime value of the call expression
  */
-RuntimeValue* evaluateCallExpression(CallExpression* expr, Environment* env) {
-    std::vector<RuntimeValue*> args; // Store the evaluated arguments
-    Expression* temp; // Temporary variable for storing the current argument expression
-    for(int i = 0; i < expr->args.size(); i++) {
-        temp = expr->args[i];
-        args.push_back(evaluate(temp, env)); // Evaluate each argument and store the result
-    }
-
-    if(dynamic_cast<FunctionValue*>(evaluate(expr->caller, env))) {
-        FunctionValue* func = dynamic_cast<FunctionValue*>(evaluate(expr->caller, env));
-        if(func->type == VALUETYPE_FUNCTION) {
-            Environment* scope = new Environment(func->declarationENV); // Create a new environment for the function scope
-
-            for(int i = 0; i < func->parameters.size(); i++) {
-                // TODO Check the bounds
-                // Verify the arity of the function
-                std::string varname = func->parameters[i];
-                scope->declareVariable(varname, args[i], false); // Declare function parameters in the function scope
-            }
+Value evaluateCallExpression(CallExpression* expr, Environment* env) {
+    ArgumentFrame frame;
+    for(auto arg : expr->args) {
+        frame.push(evaluate(arg, env)); // Evaluate each argument and store the result
+    }
+    size_t argc = frame.size();
 
-            RuntimeValue* result = MK_NULL(); // Initialize the result with null value
-            // Evaluate the function body line by line
-            for(auto stmt : func->body) {
-                result = evaluate(stmt, scope); // Evaluate each statement in the function body with the function scope
-            }
-            return result; // Return the result of the function evaluation
-        }
-    } else if(dynamic_cast<NativeFunctionValue*>(evaluate(expr->caller, env))) {
-        NativeFunctionValue* fn = dynamic_cast<NativeFunctionValue*>(evaluate(expr->caller, env));
-        RuntimeValue* result = fn->call(args, env); // Call the native function with the arguments and environment
-        return result; // Return the result of the native function call
+    // The callee stays in the frame above the arguments so that it is a root until the call ends
+    Value callee = evaluate(expr->caller, env);
+    frame.push(callee);
+
+    if(callee.isObjectOf(VALUETYPE_FUNCTION)) {
+        return callFunction(static_cast<FunctionValue*>(callee.asObject()), frame.data(), argc);
+    }
+    if(callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+        return static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(frame.data(), argc), env);
     }
     throw std::runtime_error("Cannot call a value that is not a function."); // Throw an error if the caller is not a function
 }
 
-RuntimeValue* evaluateMemberExpression(Environment* env, AssignmentExpression* node, MemberExpression* expr) {
-    if(expr != nullptr) {
-        RuntimeValue* variable = env->lookupOrMutateObject(expr, nullptr, nullptr);
+/**
+ * Read a property of an object value.
+ *
+ * @param object The value whose property is read.
+ * @param key The symbol of the property's name.
+ * @return The value of the property, or null if the object does not have it.
+ * @throws std::runtime_error if the value is not an object.
+ */
+Value getProperty(Value object, Symbol key) {
+    if(!object.isObjectOf(VALUETYPE_OBJECT)) {
+        throw std::runtime_error("Cannot read property " + symbols().name(key) + " of a " + object.getTypeName() + " value.");
+    }
+    Value* property = static_cast<ObjectValue*>(object.asObject())->findProperty(key);
+    return (property != nullptr) ? *property : MK_NULL();
+}
 
-        return variable;
+/**
+ * Get the key of a computed member access such as obj["key"].
+ *
+ * @param key The evaluated key expression.
+ * @return The symbol of the key. String literals are already interned.
+ * @throws std::runtime_error if the key is not a string.
+ */
+Symbol computedPropertyKey(Value key) {
+    if(!key.isObjectOf(VALUETYPE_STRING)) {
+        throw std::runtime_error("Computed property key must be a string, got " + key.getTypeName() + ".");
+    }
+    StringValue* string = static_cast<StringValue*>(key.asObject());
+    return (string->symbol != NO_SYMBOL) ? string->symbol : symbols().intern(string->value);
+}
+
+Value evaluateMemberExpression(Environment* env, AssignmentExpression* node, MemberExpression* expr) {
+    if(expr != nullptr) {
+        Value object = evaluate(expr->object, env);
+        Root objectRoot(object);
+        if(expr->computed) {
+            return getProperty(object, computedPropertyKey(evaluate(expr->property, env)));
+        }
+        return getPropertyCached(expr, object);
     }else if (node != nullptr) {
-        RuntimeValue* variable = env->lookupOrMutateObject(dynamic_cast<MemberExpression*>(node->assigne), evaluate(node->value, env), nullptr);
+        Value variable = env->lookupOrMutateObject(dynamic_cast<MemberExpression*>(node->assigne), evaluate(node->value, env));
 
         return variable;
     }
@@ -322,13 +532,23 @@ RuntimeValue* evaluateMemberExpression(Environment* env, AssignmentExpression* n
  * @param env - the environment in which to evaluate the expression
  * @return the result of evaluating the binary expression
  */
-RuntimeValue* evaluateBinaryExpression(BinaryExpression* binop, Environment* env) {
+Value evaluateBinaryExpression(BinaryExpression* binop, Environment* env) {
+    if (binop->unboxed) {
+        return evaluateUnboxedBinary(binop, env);
+    }
+
     // Evaluate the left and right operands
-    RuntimeValue* left = evaluate(binop->left, env);
-    RuntimeValue* right = evaluate(binop->right, env);
+    Value left = evaluate(binop->left, env);
+    if (left.isNumber()) {
+        // A number holds no heap object, so it needs no root
+        Value right = evaluate(binop->right, env);
+        return evaluateQuickenedBinary(binop, left, right);
+    }
 
-    // Return the result of evaluating the binary expression
-    return evaluateNumericBinaryExpression(left, right, binop->oper);
+    // The left operand must survive a collection triggered while evaluating the right one
+    Root leftRoot(left);
+    Value right = evaluate(binop->right, env);
+    return evaluateQuickenedBinary(binop, left, right);
 }
 
 /**
@@ -338,14 +558,20 @@ RuntimeValue* evaluateBinaryExpression(BinaryExpression* binop, Environment* env
  * @param env - the environment in which the expression is evaluated
  * @return the runtime value after assignment
  */
-RuntimeValue* evaluateAssignment(AssignmentExpression* node, Environment* env) {
+Value evaluateAssignment(AssignmentExpression* node, Environment* env) {
     if(node->assigne->getKind() != NODE_IDENTIFIER) {
         throw std::runtime_error("Invalid left-hand-side inside assignment expression.");
     }
-    // Get the variable name from the assignment expression
-    std::string varname = dynamic_cast<Iden*>(node->assigne)->value;
+    Iden* iden = dynamic_cast<Iden*>(node->assigne);
     // Evaluate the value of the assignment expression and assign it to the variable in the environment
-    return env->assignVariable(varname, evaluate(node->value, env));
+    Value value = evaluate(node->value, env);
+    if(iden->depth >= 0) {
+        if(iden->constant) {
+            throw std::runtime_error("Cannot modify constant variable: " + iden->value);
+        }
+        return env->assignSlot(iden->depth, iden->slot, value, iden->value);
+    }
+    return assignNameCached(iden, env, value);
 }
 
 /*
@@ -354,20 +580,23 @@ RuntimeValue* evaluateAssignment(AssignmentExpression* node, Environment* env) {
  * @param body The body of statements to evaluate
  * @param env The environment in which to evaluate the body
  * @param newEnv Whether to create a new environment for evaluation
+ * @param slotCount The number of slots the resolver assigned to the new environment
  * @return The result of the last evaluated statement
  */
-RuntimeValue* evaluateBody(std::vector<Statement*> body, Environment* env, bool newEnv) {
+Value evaluateBody(const std::vector<Statement*>& body, Environment* env, bool newEnv, int slotCount) {
     Environment* scope = nullptr;
     if(newEnv) {
         // Create a new environment based on the provided environment
-        scope = new Environment(env);
+        scope = heap().allocate<Environment>(env, slotCount);
     } else {
         // Use the provided environment as the scope for evaluation
         scope = env;
     }
 
+    Root scopeRoot(scope);
+
     // Initialize the result as a null value
-    RuntimeValue* result = MK_NULL();
+    Value result = MK_NULL();
 
     // Loop through each statement in the body and evaluate it in the current scope
     for(auto stmt : body) {
@@ -385,36 +614,83 @@ RuntimeValue* evaluateBody(std::vector<Statement*> body, Environment* env, bool
  * @param env The environment in which to evaluate the if statement
  * @return The result of the evaluation
  */
-RuntimeValue* evaluateIfStatement(IfStatement* ifStmt, Environment* env) {
+Value evaluateIfStatement(IfStatement* ifStmt, Environment* env) {
     // Evaluate the test expression
-    RuntimeValue* test = evaluate(ifStmt->test, env);
+    Value test = evaluate(ifStmt->test, env);
     // Check if the result is a boolean value
-    if(test->type == VALUETYPE_BOOLEAN) {
+    if(test.isBool()) {
         // If the test evaluates to true, evaluate the body
-        if(dynamic_cast<BoolValue*>(test)->value) {
-            return evaluateBody(ifStmt->body, env);
+        if(test.asBool()) {
+            return evaluateBody(ifStmt->body, env, true, ifStmt->bodyFrameSize);
         } else { // If the test evaluates to false, evaluate the alternate
-            return evaluateBody(ifStmt->alternate, env);
+            return evaluateBody(ifStmt->alternate, env, true, ifStmt->alternateFrameSize);
         }
     }
     // If the test result is not a boolean, return null
     return MK_NULL();
 }
 
+/**
+ * Evaluates a dokler or za loop. The loop runs while the test is true;
+ * a test that is not a boolean ends it, like a false one.
+ *
+ * The environment of the loop header is created once, so the update
+ * assigns the induction variable in place. The body only gets a new
+ * environment per iteration if the resolver found declarations in it.
+ *
+ * @param loop The loop to evaluate
+ * @param env The environment in which to evaluate the loop
+ * @return The value of the last iteration of the body, or null if it never ran
+ */
+Value evaluateLoopStatement(LoopStatement* loop, Environment* env) {
+    Environment* scope = loop->loopScope ? heap().allocate<Environment>(env, loop->loopFrameSize) : env;
+    Value result = MK_NULL();
+    Root scopeRoot(scope);
+    Root resultRoot(result);
+
+    if(loop->init != nullptr) {
+        evaluate(loop->init, scope);
+    }
+
+    while(true) {
+        if(loop->test != nullptr) {
+            Value test = evaluate(loop->test, scope);
+            if(!test.isBool() || !test.asBool()) {
+                break;
+            }
+        }
+        result = evaluateBody(loop->body, scope, loop->bodyScope, loop->bodyFrameSize);
+        if(loop->update != nullptr) {
+            evaluate(loop->update, scope);
+        }
+
+        // A hot loop continues compiled from the next iteration
+        if(tierSettings().enabled) {
+            ClosureLoop* compiled = countBackEdge(loop, activeArena);
+            if(compiled != nullptr) {
+                return compiled->iterations(scope, result);
+            }
+        }
+    }
+    return result;
+}
+
 /**
  * @brief Evaluate the AST node and return the runtime value.
  *
  * @param astNode The AST node to evaluate.
  * @param env The environment for evaluation.
- * @return RuntimeValue* The runtime value of the evaluated AST node.
+ * @return Value The runtime value of the evaluated AST node.
  */
-RuntimeValue* evaluate(Statement* astNode, Environment* env){
+Value evaluate(Statement* astNode, Environment* env){
     switch (astNode->getKind()) {
     case NODE_NUMERICLITERAL:
-        return dynamic_cast<RuntimeValue*>(new NumberValue(dynamic_cast<NumericLiteral*>(astNode)->value));
+        return MK_NUMBER(static_cast<NumericLiteral*>(astNode)->value);
+    case NODE_BOOLEANLITERAL:
+        return MK_BOOL(static_cast<BooleanLiteral*>(astNode)->value);
     case NODE_STRINGLITERAL:
         //  std::cout << "Evaluating string literal..." << std::endl;
-        return dynamic_cast<RuntimeValue*>(new StringValue(dynamic_cast<StringLiteral*>(astNode)->value));
+        return MK_INTERNED_STRING(static_cast<StringLiteral*>(astNode)->symbol);
     case NODE_IDENTIFIER:
         return evaluateIdentifier(dynamic_cast<Iden*>(astNode), env);
     case NODE_OBJECTLITERAL:
@@ -422,12 +698,12 @@ RuntimeValue* evaluate(Statement* astNode, Environment* env){
     case NODE_CALLEXPRESSION:
         return evaluateCallExpression(dynamic_cast<CallExpression*>(astNode), env);
     case NODE_MEMBEREXPRESSION:
-        return evaluateMemberExpression(env, dynamic_cast<AssignmentExpression*>(astNode), dynamic_cast<MemberExpression*>(astNode));
+        return evaluateMemberExpression(env, nullptr, static_cast<MemberExpression*>(astNode));
     case NODE_ASSIGNMENTEXPRESSION:
         return evaluateAssignment(dynamic_cast<AssignmentExpression*>(astNode), env);
     case NODE_BINARYEXPRESSION:
         // std::cout << "Evaluating binary expression..." << std::endl;
-        return evaluateBinaryExpression(dynamic_cast<BinaryExpression*>(astNode), env);
+        return evaluateBinaryExpression(static_cast<BinaryExpression*>(astNode), env);
     case NODE_PROGRAM:
         return evaluateProgram(dynamic_cast<Program*>(astNode), env);
     case NODE_VARIABLEDECLARATION:
@@ -437,6 +713,8 @@ RuntimeValue* evaluate(Statement* astNode, Environment* env){
     case NODE_IFEXPRESSION:
         // std::cout << "Evaluating if statement kind name: " << dynamic_cast<IfStatement*>(astNode)->getKindName() << std::endl;
         return evaluateIfStatement(dynamic_cast<IfStatement*>(astNode), env);
+    case NODE_LOOPSTATEMENT:
+        return evaluateLoopStatement(static_cast<LoopStatement*>(astNode), env);
     default:
         std::cout << "This AST node has not yet been set up for interpretation. " << std::endl;
         std::cout << "Node kind: " << astNode->getKindName() << std::endl;
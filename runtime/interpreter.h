@@ -3,21 +3,54 @@
 
 #include "values.h"
 #include "../frontend/parser.h"
+#include "../frontend/resolver.h"
 #include "environment.h"
+#include "inlinecache.h"
+#include "quicken.h"
+#include "typeinfer.h"
 
-RuntimeValue* evaluateNumericBinaryExpression(RuntimeValue* left, RuntimeValue* right, std::string op);
-RuntimeValue* evaluateIdentifier(Iden* iden, Environment* env);
-RuntimeValue* evaluateBinaryExpression(BinaryExpression* binop, Environment* env);
-RuntimeValue* evaluate(Statement* astNode, Environment* env);
-RuntimeValue* evaluateVariableDeclaration(VariableDeclaration* declaration, Environment* env);
-RuntimeValue* evaluateFunctionDeclaration(FunctionDeclaration* declaration, Environment* env);
-RuntimeValue* evaluateAssignment(AssignmentExpression* node, Environment* env);
-RuntimeValue* evaluateObject(ObjectLiteral* obj, Environment* env);
-RuntimeValue* evaluateCallExpression(CallExpression* obj, Environment* env);
-RuntimeValue* evaluateMemberExpression(Environment* env, AssignmentExpression* node, MemberExpression* expr);
-RuntimeValue* evaluateIfStatement(IfStatement* ifStmt, Environment* env);
-RuntimeValue* evaluateBody(std::vector<Statement*> body, Environment* env, bool newEnv = true);
-RuntimeValue* compare(RuntimeValue* lhs, RuntimeValue* rhs, bool strict);
-RuntimeValue* equals(RuntimeValue* lhs, RuntimeValue* rhs, bool strict);
+Value evaluateNumericBinaryExpression(Value left, Value right, OperatorType op);
+Value evaluateIdentifier(Iden* iden, Environment* env);
+Value evaluateBinaryExpression(BinaryExpression* binop, Environment* env);
+Value evaluate(Statement* astNode, Environment* env);
+Value evaluateVariableDeclaration(VariableDeclaration* declaration, Environment* env);
+Value evaluateFunctionDeclaration(FunctionDeclaration* declaration, Environment* env);
+Value declareFunction(FunctionDeclaration* declaration, Environment* env, const std::shared_ptr<AstArena>& arena);
+Value evaluateAssignment(AssignmentExpression* node, Environment* env);
+Value evaluateObject(ObjectLiteral* obj, Environment* env);
+Value evaluateCallExpression(CallExpression* obj, Environment* env);
+Environment* bindArguments(FunctionValue* func, const Value* args, size_t argc);
+Value callFunction(FunctionValue* func, const Value* args, size_t argc);
+Value evaluateMemberExpression(Environment* env, AssignmentExpression* node, MemberExpression* expr);
+Value getProperty(Value object, Symbol key);
+Symbol computedPropertyKey(Value key);
+Value evaluateIfStatement(IfStatement* ifStmt, Environment* env);
+Value evaluateLoopStatement(LoopStatement* loop, Environment* env);
+Value evaluateBody(const std::vector<Statement*>& body, Environment* env, bool newEnv = true, int slotCount = 0);
+Value compare(Value lhs, Value rhs, bool strict);
+
+// Skupni medpomnilnik argumentov klicev, vse vrednosti v njem so koreni
+std::vector<Value>& argumentBuffer();
+
+// Argumenti enega klica na vrhu medpomnilnika argumentov
+// Odstranijo se, ko okvir zapusti obseg, tudi ob napakah
+class ArgumentFrame {
+  public:
+    ArgumentFrame() : buffer(argumentBuffer()), base(buffer.size()) {}
+    ~ArgumentFrame() { this->buffer.resize(this->base); }
+
+    void push(Value value) { this->buffer.push_back(value); }
+
+    // Kazalec na prvi argument, veljaven do naslednjega vstavljanja v medpomnilnik
+    const Value* data() const { return this->buffer.data() + this->base; }
+    size_t size() const { return this->buffer.size() - this->base; }
+
+    void clear() { this->buffer.resize(this->base); }
+
+  private:
+    std::vector<Value>& buffer;
+    size_t base;
+};
+Value equals(Value lhs, Value rhs, bool strict);
 
 #endif
\ No newline at end of file
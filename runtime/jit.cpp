@@ -0,0 +1,738 @@
+#include "jit.h"
+#include "compiler.h"
+
+#include <cmath>
+#include <cstring>
+
+JitSettings& jitSettings() {
+    static JitSettings settings;
+    return settings;
+}
+
+#if SLO_JIT
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+// Deeper native recursion leaves the call to the interpreter
+static const uint64_t JIT_MAX_DEPTH = 10000;
+
+// A function whose code bails out this often goes back to the interpreter for good
+static const uint32_t JIT_MAX_BAILOUTS = 16;
+
+// Arguments of compiled functions and native calls are passed in fixed arrays
+static const size_t JIT_MAX_ARGUMENTS = 16;
+
+// State shared by all frames of one call into compiled code, addressed through r12
+struct JitContext {
+    uint64_t depth = 0;
+    uint8_t bailout = 0;
+    Environment* env = nullptr;
+};
+
+using JitEntry = double (*)(const double* args, JitContext* context);
+
+// Machine code of one declaration in its own executable pages
+struct JitCode {
+    void* memory = nullptr;
+    size_t size = 0;
+    JitEntry entry = nullptr;
+    uint32_t bailouts = 0;
+
+    JitCode(const std::vector<uint8_t>& bytes) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        this->size = (bytes.size() + page - 1) / page * page;
+
+        // The pages are never writable and executable at the same time
+        void* memory = mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw CompileError("Cannot allocate executable memory.");
+        }
+        std::memcpy(memory, bytes.data(), bytes.size());
+        if (mprotect(memory, this->size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, this->size);
+            throw CompileError("Cannot make compiled code executable.");
+        }
+        this->memory = memory;
+        this->entry = reinterpret_cast<JitEntry>(memory);
+    }
+
+    ~JitCode() {
+        munmap(this->memory, this->size);
+    }
+
+    JitCode(const JitCode&) = delete;
+    JitCode& operator=(const JitCode&) = delete;
+};
+
+/**
+ * Call a native function from compiled code. Exceptions must not unwind
+ * through compiled frames, so errors and non-number results only set the
+ * bailout flag and the interpreter repeats the call.
+ */
+static double jitCallNative(JitContext* context, NativeFunctionValue* native, const double* args, uint64_t argc) {
+    Value values[JIT_MAX_ARGUMENTS];
+    for (uint64_t i = 0; i < argc; i++) {
+        values[i] = MK_NUMBER(args[i]);
+    }
+    try {
+        Value result = native->call(ArgumentSpan(values, argc), context->env);
+        if (result.isNumber()) {
+            return result.asNumber();
+        }
+    } catch (...) {
+    }
+    context->bailout = 1;
+    return 0.0;
+}
+
+// fmod has overloads, compiled code needs the address of exactly one
+static double jitModulo(double left, double right) {
+    return std::fmod(left, right);
+}
+
+// Condition codes of jcc rel32 (second opcode byte)
+enum JitCondition : uint8_t {
+    JIT_JUMP = 0x00,
+    JIT_BELOW = 0x82,
+    JIT_EQUAL = 0x84,
+    JIT_NOT_EQUAL = 0x85,
+    JIT_BELOW_EQUAL = 0x86,
+    JIT_PARITY = 0x8A,
+    JIT_GREATER = 0x8F
+};
+
+/**
+ * Single-pass code generator for one function body. Expressions leave
+ * their value in xmm0, intermediate values go to the machine stack and
+ * every local variable has a fixed slot in the frame. rbx holds the
+ * argument array and r12 the shared context. Anything outside the numeric
+ * subset throws a CompileError and the function stays interpreted.
+ */
+class JitCompiler {
+  private:
+    FunctionDeclaration* function;
+    Environment* globals;
+    std::vector<uint8_t> code = {};
+
+    // Environments on the path of the walk: first frame slot and declared slots
+    std::vector<int> scopes = {};
+    std::vector<std::vector<bool>> declared = {};
+
+    // Frame slots in use and the most ever used
+    int locals = 0;
+    int maxLocals = 0;
+
+    // Values pushed to the machine stack by the expression being compiled
+    int pushed = 0;
+
+    size_t bodyStart = 0;
+    std::vector<size_t> bailJumps = {};
+
+    void bytes(std::initializer_list<uint8_t> values) {
+        this->code.insert(this->code.end(), values);
+    }
+
+    void imm32(int32_t value) {
+        uint8_t raw[4];
+        std::memcpy(raw, &value, 4);
+        this->code.insert(this->code.end(), raw, raw + 4);
+    }
+
+    void imm64(uint64_t value) {
+        uint8_t raw[8];
+        std::memcpy(raw, &value, 8);
+        this->code.insert(this->code.end(), raw, raw + 8);
+    }
+
+    // Emit a jump with an empty rel32 and return the position to patch
+    size_t jump(JitCondition condition) {
+        if (condition == JIT_JUMP) {
+            this->bytes({0xE9});
+        } else {
+            this->bytes({0x0F, condition});
+        }
+        this->imm32(0);
+        return this->code.size() - 4;
+    }
+
+    void patch(size_t at, size_t target) {
+        int32_t rel = (int32_t)(target - (at + 4));
+        std::memcpy(&this->code[at], &rel, 4);
+    }
+
+    void bind(const std::vector<size_t>& jumps) {
+        for (size_t at : jumps) {
+            this->patch(at, this->code.size());
+        }
+    }
+
+    void bail(JitCondition condition) {
+        this->bailJumps.push_back(this->jump(condition));
+    }
+
+    // Displacement of a frame slot from rbp, below the saved rbx and r12
+    static int32_t frameOffset(int local) {
+        return -24 - 8 * local;
+    }
+
+    void loadLocal(int local, int xmm) {
+        this->bytes({0xF2, 0x0F, 0x10, (uint8_t)(0x85 | (xmm << 3))});
+        this->imm32(frameOffset(local));
+    }
+
+    void storeLocal(int local) {
+        this->bytes({0xF2, 0x0F, 0x11, 0x85});
+        this->imm32(frameOffset(local));
+    }
+
+    void loadConstant(double value, int xmm) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, 8);
+        this->bytes({0x48, 0xB8});
+        this->imm64(bits);
+        this->bytes({0x66, 0x48, 0x0F, 0x6E, (uint8_t)(0xC0 | (xmm << 3))});
+    }
+
+    void push() {
+        this->bytes({0x48, 0x83, 0xEC, 0x08, 0xF2, 0x0F, 0x11, 0x04, 0x24});
+        this->pushed++;
+    }
+
+    // Right operand from xmm0 to xmm1, left operand from the stack to xmm0
+    void pop() {
+        this->bytes({0xF2, 0x0F, 0x10, 0xC8, 0xF2, 0x0F, 0x10, 0x04, 0x24, 0x48, 0x83, 0xC4, 0x08});
+        this->pushed--;
+    }
+
+    // Calls need a 16-byte aligned stack
+    void call(uint64_t target) {
+        bool pad = (this->pushed % 2) != 0;
+        if (pad) {
+            this->bytes({0x48, 0x83, 0xEC, 0x08});
+        }
+        if (target == 0) {
+            this->bytes({0xE8});
+            this->imm32((int32_t)(0 - (this->code.size() + 4)));
+        } else {
+            this->bytes({0x48, 0xB8});
+            this->imm64(target);
+            this->bytes({0xFF, 0xD0});
+        }
+        if (pad) {
+            this->bytes({0x48, 0x83, 0xC4, 0x08});
+        }
+    }
+
+    // Leave the call if the callee set the bailout flag
+    void checkBailout() {
+        this->bytes({0x41, 0x80, 0x7C, 0x24, (uint8_t)offsetof(JitContext, bailout), 0x00});
+        this->bail(JIT_NOT_EQUAL);
+    }
+
+    void enterScope(int size) {
+        this->scopes.push_back(this->locals);
+        this->declared.emplace_back(size, false);
+        this->reserve(size);
+    }
+
+    void leaveScope() {
+        this->locals = this->scopes.back();
+        this->scopes.pop_back();
+        this->declared.pop_back();
+    }
+
+    int reserve(int count) {
+        int first = this->locals;
+        this->locals += count;
+        this->maxLocals = std::max(this->maxLocals, this->locals);
+        return first;
+    }
+
+    // Frame slot of a resolved local, only environments of this function can be read
+    int local(int depth, int slot) {
+        if (depth < 0 || (size_t)depth >= this->scopes.size()) {
+            throw CompileError("Variable outside of the function.");
+        }
+        return this->scopes[this->scopes.size() - 1 - depth] + slot;
+    }
+
+    bool isSimple(Expression* expr) {
+        return expr->getKind() == NODE_NUMERICLITERAL ||
+               (expr->getKind() == NODE_IDENTIFIER && static_cast<Iden*>(expr)->depth >= 0);
+    }
+
+    void loadSimple(Expression* expr, int xmm) {
+        if (expr->getKind() == NODE_NUMERICLITERAL) {
+            this->loadConstant(static_cast<NumericLiteral*>(expr)->value, xmm);
+        } else {
+            Iden* iden = static_cast<Iden*>(expr);
+            this->loadLocal(this->local(iden->depth, iden->slot), xmm);
+        }
+    }
+
+    // Left operand to xmm0, right operand to xmm1, in evaluation order
+    void operands(BinaryExpression* binop) {
+        this->expression(binop->left);
+        if (this->isSimple(binop->right)) {
+            this->loadSimple(binop->right, 1);
+            return;
+        }
+        this->push();
+        this->expression(binop->right);
+        this->pop();
+    }
+
+    // Division and modulo by zero throw in the interpreter (NaN is not zero)
+    void checkDivisor() {
+        this->bytes({0x66, 0x0F, 0x57, 0xD2, 0x66, 0x0F, 0x2E, 0xCA, 0x7A, 0x06});
+        this->bail(JIT_EQUAL);
+    }
+
+    void arithmetic(BinaryExpression* binop) {
+        this->operands(binop);
+        switch (binop->oper) {
+        case OP_ADD:
+            this->bytes({0xF2, 0x0F, 0x58, 0xC1});
+            break;
+        case OP_SUBTRACT:
+            this->bytes({0xF2, 0x0F, 0x5C, 0xC1});
+            break;
+        case OP_MULTIPLY:
+            this->bytes({0xF2, 0x0F, 0x59, 0xC1});
+            break;
+        case OP_DIVIDE:
+            this->checkDivisor();
+            this->bytes({0xF2, 0x0F, 0x5E, 0xC1});
+            break;
+        case OP_MODULO:
+            this->checkDivisor();
+            this->call((uint64_t)(uintptr_t)&jitModulo);
+            break;
+        default:
+            throw CompileError("Comparison used as a value.");
+        }
+    }
+
+    // Frame slots grow downwards, so the argument array is filled from its last slot
+    static int argumentSlot(int first, size_t count, size_t i) {
+        return first + (int)(count - 1 - i);
+    }
+
+    // Evaluate the arguments of a call into an array of frame slots
+    int arguments(CallExpression* call) {
+        if (call->args.size() > JIT_MAX_ARGUMENTS) {
+            throw CompileError("Too many arguments.");
+        }
+        int first = this->reserve((int)call->args.size());
+        for (size_t i = 0; i < call->args.size(); i++) {
+            this->expression(call->args[i]);
+            this->storeLocal(argumentSlot(first, call->args.size(), i));
+        }
+        return first;
+    }
+
+    /**
+     * Compile a call of a constant global: the function itself or a pure
+     * native. The binding cannot change once the function is hot, so the
+     * callee is fixed in the code.
+     */
+    void callExpression(CallExpression* call) {
+        if (call->caller->getKind() != NODE_IDENTIFIER || static_cast<Iden*>(call->caller)->depth >= 0) {
+            throw CompileError("Callee is not a global.");
+        }
+        Binding* binding = this->globals->lookupBinding(static_cast<Iden*>(call->caller)->symbol);
+        if (binding == nullptr || !binding->constant) {
+            throw CompileError("Callee is not a constant.");
+        }
+
+        int saved = this->locals;
+        Value callee = binding->value;
+        if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            FunctionValue* target = static_cast<FunctionValue*>(callee.asObject());
+            if (target->prototype->declaration != this->function || call->args.size() != this->function->parameters.size()) {
+                throw CompileError("Only calls of the function itself are compiled.");
+            }
+            int args = this->arguments(call);
+
+            // A tail call of itself overwrites the parameters and jumps back to the body
+            if (call->tail && this->pushed == 0) {
+                for (size_t i = 0; i < call->args.size(); i++) {
+                    this->loadLocal(argumentSlot(args, call->args.size(), i), 0);
+                    this->storeLocal(this->scopes.front() + (int)i);
+                }
+                this->patch(this->jump(JIT_JUMP), this->bodyStart);
+            } else {
+                // lea rdi, [rbp + args]; mov rsi, r12
+                this->bytes({0x48, 0x8D, 0xBD});
+                this->imm32(frameOffset(args + (int)call->args.size() - 1));
+                this->bytes({0x4C, 0x89, 0xE6});
+                this->call(0);
+                this->checkBailout();
+            }
+        } else if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            NativeFunctionValue* native = static_cast<NativeFunctionValue*>(callee.asObject());
+            if (!native->pure) {
+                throw CompileError("Native function is not pure.");
+            }
+            if (native->unary != nullptr && call->args.size() == 1) {
+                // A pure double(double) takes the argument in xmm0 and cannot fail
+                this->expression(call->args[0]);
+                this->call((uint64_t)(uintptr_t)native->unary);
+                this->locals = saved;
+                return;
+            }
+            int args = this->arguments(call);
+
+            // mov rdi, r12; mov rsi, native; lea rdx, [rbp + args]; mov rcx, argc
+            this->bytes({0x4C, 0x89, 0xE7, 0x48, 0xBE});
+            this->imm64((uint64_t)(uintptr_t)native);
+            this->bytes({0x48, 0x8D, 0x95});
+            this->imm32(frameOffset(args + (int)call->args.size() - 1));
+            this->bytes({0x48, 0xB9});
+            this->imm64(call->args.size());
+            this->call((uint64_t)(uintptr_t)&jitCallNative);
+            this->checkBailout();
+        } else {
+            throw CompileError("Callee is not a function.");
+        }
+        this->locals = saved;
+    }
+
+    void expression(Expression* expr) {
+        switch (expr->getKind()) {
+        case NODE_NUMERICLITERAL:
+        case NODE_IDENTIFIER:
+            if (!this->isSimple(expr)) {
+                throw CompileError("Global variable.");
+            }
+            this->loadSimple(expr, 0);
+            return;
+        case NODE_BINARYEXPRESSION:
+            this->arithmetic(static_cast<BinaryExpression*>(expr));
+            return;
+        case NODE_ASSIGNMENTEXPRESSION: {
+            AssignmentExpression* assignment = static_cast<AssignmentExpression*>(expr);
+            if (assignment->assigne->getKind() != NODE_IDENTIFIER) {
+                throw CompileError("Assignment to a property.");
+            }
+            Iden* iden = static_cast<Iden*>(assignment->assigne);
+            if (iden->constant) {
+                throw CompileError("Assignment to a constant.");
+            }
+            int target = this->local(iden->depth, iden->slot);
+            this->expression(assignment->value);
+            this->storeLocal(target);
+            return;
+        }
+        case NODE_CALLEXPRESSION:
+            this->callExpression(static_cast<CallExpression*>(expr));
+            return;
+        default:
+            throw CompileError("Expression is not numeric.");
+        }
+    }
+
+    /**
+     * Compile a test that jumps to the returned positions when it is false.
+     * Comparisons follow IEEE semantics like the interpreter: every
+     * comparison with NaN is false except !=.
+     */
+    std::vector<size_t> condition(Expression* test) {
+        std::vector<size_t> falseJumps;
+        if (test->getKind() == NODE_BOOLEANLITERAL) {
+            if (!static_cast<BooleanLiteral*>(test)->value) {
+                falseJumps.push_back(this->jump(JIT_JUMP));
+            }
+            return falseJumps;
+        }
+        if (test->getKind() != NODE_BINARYEXPRESSION) {
+            throw CompileError("Test is not a comparison.");
+        }
+        BinaryExpression* binop = static_cast<BinaryExpression*>(test);
+        switch (binop->oper) {
+        case OP_EQUALS:
+        case OP_NOT_EQUALS:
+        case OP_LESS:
+        case OP_GREATER:
+        case OP_LESS_EQUALS:
+        case OP_GREATER_EQUALS:
+            break;
+        default:
+            throw CompileError("Test is not a comparison.");
+        }
+
+        this->operands(binop);
+        switch (binop->oper) {
+        case OP_LESS:
+            this->bytes({0x66, 0x0F, 0x2E, 0xC8});
+            falseJumps.push_back(this->jump(JIT_BELOW_EQUAL));
+            break;
+        case OP_LESS_EQUALS:
+            this->bytes({0x66, 0x0F, 0x2E, 0xC8});
+            falseJumps.push_back(this->jump(JIT_BELOW));
+            break;
+        case OP_GREATER:
+            this->bytes({0x66, 0x0F, 0x2E, 0xC1});
+            falseJumps.push_back(this->jump(JIT_BELOW_EQUAL));
+            break;
+        case OP_GREATER_EQUALS:
+            this->bytes({0x66, 0x0F, 0x2E, 0xC1});
+            falseJumps.push_back(this->jump(JIT_BELOW));
+            break;
+        case OP_EQUALS:
+            this->bytes({0x66, 0x0F, 0x2E, 0xC1});
+            falseJumps.push_back(this->jump(JIT_PARITY));
+            falseJumps.push_back(this->jump(JIT_NOT_EQUAL));
+            break;
+        default:
+            // Unordered operands are not equal, so jp skips the je
+            this->bytes({0x66, 0x0F, 0x2E, 0xC1, 0x7A, 0x06});
+            falseJumps.push_back(this->jump(JIT_EQUAL));
+            break;
+        }
+        return falseJumps;
+    }
+
+    // Compile a body; if value is set, every path must leave a number in xmm0
+    void body(const std::vector<Statement*>& statements, bool value) {
+        if (value && statements.empty()) {
+            throw CompileError("Empty body has no numeric value.");
+        }
+        for (size_t i = 0; i < statements.size(); i++) {
+            this->statement(statements[i], value && i + 1 == statements.size());
+        }
+    }
+
+    void scopedBody(const std::vector<Statement*>& statements, int size, bool value) {
+        this->enterScope(size);
+        this->body(statements, value);
+        this->leaveScope();
+    }
+
+    void statement(Statement* stmt, bool value) {
+        switch (stmt->getKind()) {
+        case NODE_VARIABLEDECLARATION: {
+            VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+            if (declaration->slot < 0 || declaration->expressionValue == nullptr) {
+                throw CompileError("Declaration without a numeric value.");
+            }
+            // Declaring a slot twice in one environment throws in the interpreter
+            std::vector<bool>& declared = this->declared.back();
+            if (declared[declaration->slot]) {
+                throw CompileError("Variable declared twice.");
+            }
+            declared[declaration->slot] = true;
+            this->expression(declaration->expressionValue);
+            this->storeLocal(this->scopes.back() + declaration->slot);
+            return;
+        }
+        case NODE_IFEXPRESSION: {
+            IfStatement* ifStmt = static_cast<IfStatement*>(stmt);
+            std::vector<size_t> falseJumps = this->condition(ifStmt->test);
+            this->scopedBody(ifStmt->body, ifStmt->bodyFrameSize, value);
+            size_t end = this->jump(JIT_JUMP);
+            this->bind(falseJumps);
+            this->scopedBody(ifStmt->alternate, ifStmt->alternateFrameSize, value);
+            this->patch(end, this->code.size());
+            return;
+        }
+        case NODE_LOOPSTATEMENT: {
+            // A loop that never runs its body has the value null
+            LoopStatement* loop = static_cast<LoopStatement*>(stmt);
+            if (value) {
+                throw CompileError("Loop as the value of the function.");
+            }
+            if (loop->loopScope) {
+                this->enterScope(loop->loopFrameSize);
+            }
+            if (loop->init != nullptr) {
+                this->statement(loop->init, false);
+            }
+            size_t top = this->code.size();
+            std::vector<size_t> exitJumps;
+            if (loop->test != nullptr) {
+                exitJumps = this->condition(loop->test);
+            }
+            if (loop->bodyScope) {
+                this->scopedBody(loop->body, loop->bodyFrameSize, false);
+            } else {
+                this->body(loop->body, false);
+            }
+            if (loop->update != nullptr) {
+                this->expression(loop->update);
+            }
+            this->patch(this->jump(JIT_JUMP), top);
+            this->bind(exitJumps);
+            if (loop->loopScope) {
+                this->leaveScope();
+            }
+            return;
+        }
+        case NODE_NUMERICLITERAL:
+        case NODE_IDENTIFIER:
+        case NODE_BINARYEXPRESSION:
+        case NODE_ASSIGNMENTEXPRESSION:
+        case NODE_CALLEXPRESSION:
+            this->expression(static_cast<Expression*>(stmt));
+            return;
+        default:
+            throw CompileError("Statement is not numeric.");
+        }
+    }
+
+  public:
+    JitCompiler(FunctionDeclaration* function, Environment* globals) : function(function), globals(globals) {}
+
+    std::shared_ptr<JitCode> compile() {
+        FunctionDeclaration* function = this->function;
+        if (!function->resolved || function->parameters.size() > JIT_MAX_ARGUMENTS) {
+            throw CompileError("Function cannot be compiled.");
+        }
+
+        // push rbp; mov rbp, rsp; push rbx; push r12; sub rsp, frame
+        this->bytes({0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x48, 0x81, 0xEC});
+        size_t frameSize = this->code.size();
+        this->imm32(0);
+
+        // mov rbx, rdi; mov r12, rsi
+        this->bytes({0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4});
+
+        // inc qword [r12 + depth]; cmp qword [r12 + depth], limit
+        uint8_t depth = (uint8_t)offsetof(JitContext, depth);
+        this->bytes({0x49, 0xFF, 0x44, 0x24, depth, 0x49, 0x81, 0x7C, 0x24, depth});
+        this->imm32((int32_t)JIT_MAX_DEPTH);
+        this->bail(JIT_GREATER);
+
+        // Parameters are the first slots of the function environment
+        this->enterScope(std::max(function->frameSize, (int)function->parameters.size()));
+        for (size_t i = 0; i < function->parameters.size(); i++) {
+            this->bytes({0xF2, 0x0F, 0x10, 0x83});
+            this->imm32((int32_t)(8 * i));
+            this->storeLocal((int)i);
+            this->declared.back()[i] = true;
+        }
+        this->bodyStart = this->code.size();
+        this->body(function->body, true);
+        this->leaveScope();
+
+        // dec qword [r12 + depth]; lea rsp, [rbp - 16]; pop r12; pop rbx; pop rbp; ret
+        size_t exit = this->code.size();
+        this->bytes({0x49, 0xFF, 0x4C, 0x24, depth, 0x48, 0x8D, 0x65, 0xF0, 0x41, 0x5C, 0x5B, 0x5D, 0xC3});
+
+        // mov byte [r12 + bailout], 1; jmp exit
+        this->bind(this->bailJumps);
+        this->bytes({0x41, 0xC6, 0x44, 0x24, (uint8_t)offsetof(JitContext, bailout), 0x01});
+        this->patch(this->jump(JIT_JUMP), exit);
+
+        int32_t frame = (int32_t)((8 * this->maxLocals + 15) / 16 * 16);
+        std::memcpy(&this->code[frameSize], &frame, 4);
+        return std::make_shared<JitCode>(this->code);
+    }
+};
+
+bool compileJit(FunctionValue* func) {
+    FunctionDeclaration* declaration = func->prototype->declaration;
+    if (declaration->jitCode) {
+        return true;
+    }
+    if (declaration->jitFailed) {
+        return false;
+    }
+    try {
+        declaration->jitCode = JitCompiler(declaration, func->declarationENV).compile();
+    } catch (const CompileError&) {
+        declaration->jitFailed = true;
+        runtimeStats().jitRejected++;
+        return false;
+    }
+    runtimeStats().jitFunctions++;
+    return true;
+}
+
+/**
+ * Run the call again without compiled code and compare the results.
+ * The interpreter is the reference, so its result is the one returned.
+ */
+static Value verifyJit(FunctionValue* func, const Value* args, size_t argc, Value result) {
+    JitSettings& settings = jitSettings();
+    settings.suspended = true;
+    Value expected = MK_NULL();
+    try {
+        expected = callClosure(func, args, argc);
+    } catch (...) {
+        settings.suspended = false;
+        throw;
+    }
+    settings.suspended = false;
+
+    runtimeStats().jitVerified++;
+    double actual = result.asNumber();
+    bool same = expected.isNumber() &&
+                (expected.asNumber() == actual || (std::isnan(expected.asNumber()) && std::isnan(actual)));
+    if (!same) {
+        runtimeStats().jitMismatches++;
+        std::cerr << "JIT: funkcija " << func->prototype->name << " vrne " << actual << ", interpreter pa ";
+        if (expected.isNumber()) {
+            std::cerr << expected.asNumber() << std::endl;
+        } else {
+            std::cerr << "vrednost, ki ni stevilo" << std::endl;
+        }
+    }
+    return expected;
+}
+
+bool runJit(FunctionValue* func, const Value* args, size_t argc, Value& result) {
+    FunctionDeclaration* declaration = func->prototype->declaration;
+    JitCode* code = declaration->jitCode.get();
+    if (code == nullptr || jitSettings().suspended) {
+        return false;
+    }
+
+    size_t count = declaration->parameters.size();
+    if (argc < count) {
+        return false;
+    }
+    double numbers[JIT_MAX_ARGUMENTS];
+    for (size_t i = 0; i < count; i++) {
+        if (!args[i].isNumber()) {
+            return false;
+        }
+        numbers[i] = args[i].asNumber();
+    }
+
+    JitContext context;
+    context.env = func->declarationENV;
+    double value = code->entry(numbers, &context);
+    if (context.bailout) {
+        runtimeStats().jitBailouts++;
+        if (++code->bailouts >= JIT_MAX_BAILOUTS) {
+            declaration->jitCode.reset();
+            declaration->jitFailed = true;
+        }
+        return false;
+    }
+
+    runtimeStats().jitCalls++;
+    result = MK_NUMBER(value);
+    if (jitSettings().verify) {
+        result = verifyJit(func, args, argc, result);
+    }
+    return true;
+}
+
+#else
+
+struct JitCode {};
+
+bool compileJit(FunctionValue*) {
+    return false;
+}
+
+bool runJit(FunctionValue*, const Value*, size_t, Value&) {
+    return false;
+}
+
+#endif
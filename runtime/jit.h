@@ -0,0 +1,45 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "closures.h"
+
+// Osnovni prevajalnik stevilskih funkcij v strojno kodo x86-64
+// Ob prehodu praga vrocine (runtime/tiering.h) se poskusi prevesti tudi telo
+// funkcije, ki racuna le s stevili: parametri, lokalne spremenljivke, literali,
+// aritmetika, primerjave v pogojih, pogojni stavki, zanke, klici same sebe in
+// cistih vgrajenih funkcij. Vse vrednosti so double v okvirju na skladu,
+// koda je v izvrsljivih straneh, dobljenih z mmap.
+// Prevedena koda se izvede le, ce so vsi argumenti stevila. Take funkcije nimajo
+// stranskih ucinkov, zato ob vsem nenavadnem (deljenje z 0, napaka vgrajene
+// funkcije, pregloboka rekurzija) klic opusti in ga v celoti ponovi interpreter,
+// ki vrze pravo napako. Funkcija, ki prepogosto izstopi, se vrne v interpreter.
+
+#if defined(__x86_64__) && defined(__linux__)
+#define SLO_JIT 1
+#else
+#define SLO_JIT 0
+#endif
+
+struct JitSettings {
+    // Vklopljeno z --jit, le za drevesni interpreter s stopnjami izvajanja
+    bool enabled = false;
+
+    // Vsak klic prevedene kode ponovi se interpreter in primerja rezultata (--jit-verify)
+    bool verify = false;
+
+    // Med preverjanjem se prevedena koda ne izvaja
+    bool suspended = false;
+};
+
+JitSettings& jitSettings();
+
+// Poskusi prevesti telo vroce funkcije, vrne true ob uspehu
+// Neuspeh se zabelezi v deklaraciji, zato se prevajanje ne ponavlja
+bool compileJit(FunctionValue* func);
+
+// Izvedi prevedeno kodo funkcije
+// Vrne false, ce kode ni, argumenti niso stevila ali je koda izstopila,
+// takrat mora klic izvesti interpreter
+bool runJit(FunctionValue* func, const Value* args, size_t argc, Value& result);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+
+#include "environment.h"
+
+#include <type_traits>
+#include <utility>
+
+// Vezave vgrajenih funkcij, ustvarjene ob prevajanju iz navadnih C++ funkcij
+// Funkcija s podpisom double(double) postane vgrajena funkcija z eno vrstico:
+//     defineNative<kvadrat>(env, "Kvadrat");
+// Vezava preveri stevilo argumentov, razpakira argumente brez dynamic_cast
+// in zapakira rezultat. Podprti tipi so double, bool in Value.
+
+// Razpakiranje argumenta v tip parametra C++ funkcije
+template <typename T> struct NativeArgument;
+
+template <> struct NativeArgument<double> {
+    static double get(Value value, size_t index) {
+        if (!value.isNumber()) {
+            throw std::runtime_error("Native function expects a number as argument " + std::to_string(index + 1) + ".");
+        }
+        return value.asNumber();
+    }
+};
+
+template <> struct NativeArgument<bool> {
+    static bool get(Value value, size_t index) {
+        if (!value.isBool()) {
+            throw std::runtime_error("Native function expects a boolean as argument " + std::to_string(index + 1) + ".");
+        }
+        return value.asBool();
+    }
+};
+
+template <> struct NativeArgument<Value> {
+    static Value get(Value value, size_t) { return value; }
+};
+
+// Zapakiranje rezultata C++ funkcije
+inline Value nativeResult(double result) { return MK_NUMBER(result); }
+inline Value nativeResult(bool result) { return MK_BOOL(result); }
+inline Value nativeResult(Value result) { return result; }
+
+// Podpis C++ funkcije, iz katerega se izpelje vezava
+template <typename Signature> struct NativeSignature;
+
+template <typename R, typename... Params> struct NativeSignature<R (*)(Params...)> {
+    static constexpr size_t arity = sizeof...(Params);
+
+    template <auto Fn, size_t... I> static Value invoke(ArgumentSpan args, std::index_sequence<I...>) {
+        return nativeResult(Fn(NativeArgument<std::decay_t<Params>>::get(args[I], I)...));
+    }
+};
+
+// Vezava C++ funkcije Fn v klicni dogovor vgrajenih funkcij
+template <auto Fn> Value nativeBinding(ArgumentSpan args, Environment*) {
+    using Signature = NativeSignature<decltype(Fn)>;
+    if (args.size() != Signature::arity) {
+        throw std::runtime_error("Native function expects " + std::to_string(Signature::arity) + " argument(s), got " + std::to_string(args.size()) + ".");
+    }
+    return Signature::template invoke<Fn>(args, std::make_index_sequence<Signature::arity>{});
+}
+
+// Deklariraj C++ funkcijo Fn kot konstanto v okolju
+// Ciste funkcije (pure) lahko izracuna ze zlaganje konstant,
+// ciste funkcije double(double) pa strojna koda klice neposredno
+template <auto Fn> void defineNative(Environment* env, const std::string& name, bool pure = false) {
+    Value native = MK_NATIVE_FUNCTION(nativeBinding<Fn>);
+    NativeFunctionValue* function = static_cast<NativeFunctionValue*>(native.asObject());
+    function->pure = pure;
+    if constexpr (std::is_same_v<decltype(Fn), double (*)(double)>) {
+        if (pure) {
+            function->unary = Fn;
+        }
+    }
+    env->declareVariable(name, native, true);
+}
+
+#endif
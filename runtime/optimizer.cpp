@@ -0,0 +1,285 @@
+#include "optimizer.h"
+#include "interpreter.h"
+
+ConstantFolder::ConstantFolder(Environment* globals, AstArena* arena) : globals(globals), arena(arena) {}
+
+Value ConstantFolder::literalValue(Expression* expr) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL:
+        return MK_NUMBER(static_cast<NumericLiteral*>(expr)->value);
+    case NODE_BOOLEANLITERAL:
+        return MK_BOOL(static_cast<BooleanLiteral*>(expr)->value);
+    case NODE_STRINGLITERAL:
+        return MK_INTERNED_STRING(static_cast<StringLiteral*>(expr)->symbol);
+    default:
+        return Value::empty();
+    }
+}
+
+/**
+ * Create a literal node for a value computed at compile time. Only
+ * numbers, booleans and interned strings have a literal form; a string
+ * literal evaluates to the same interned string the value already is.
+ *
+ * @param value The value of the folded expression.
+ * @return The literal, or nullptr if the value cannot be written as one.
+ */
+Expression* ConstantFolder::makeLiteral(Value value) {
+    if (value.isNumber()) {
+        return this->arena->make<NumericLiteral>(value.asNumber());
+    }
+    if (value.isBool()) {
+        return this->arena->make<BooleanLiteral>(value.asBool());
+    }
+    if (value.isObjectOf(VALUETYPE_STRING)) {
+        StringValue* string = static_cast<StringValue*>(value.asObject());
+        if (string->symbol != NO_SYMBOL) {
+            return this->arena->make<StringLiteral>(string->value, string->symbol);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Find the value of the constant an identifier refers to. Resolved
+ * identifiers look in the frame their depth points to, which only holds
+ * the constants declared before this point of the program. Names looked up
+ * at runtime see the program's own global constants and the constant
+ * bindings of the global environment (builtins and earlier REPL lines),
+ * which can be neither reassigned nor redeclared.
+ *
+ * @param iden The identifier.
+ * @return The value of the constant, or Value::empty() if it is not known.
+ */
+Value ConstantFolder::knownConstant(Iden* iden) {
+    if (iden->depth >= 0) {
+        if ((size_t)iden->depth >= this->frames.size()) {
+            return Value::empty();
+        }
+        const std::vector<Value>& frame = this->frames[this->frames.size() - 1 - iden->depth];
+        return ((size_t)iden->slot < frame.size()) ? frame[iden->slot] : Value::empty();
+    }
+
+    auto it = this->constants.find(iden->symbol);
+    if (it != this->constants.end()) {
+        return it->second;
+    }
+    Binding* binding = this->globals->lookupBinding(iden->symbol);
+    return (binding != nullptr && binding->constant) ? binding->value : Value::empty();
+}
+
+/**
+ * Fold a call. A call to a pure native function whose arguments are all
+ * constants is replaced by its result.
+ *
+ * @param call The call expression.
+ * @return The call, or a literal holding its result.
+ */
+Expression* ConstantFolder::foldCall(CallExpression* call) {
+    std::vector<Value> args;
+    bool constantArgs = true;
+    for (auto& arg : call->args) {
+        arg = this->fold(arg);
+        Value value = this->literalValue(arg);
+        constantArgs = constantArgs && !value.isEmpty();
+        args.push_back(value);
+    }
+
+    // The callee itself is never replaced by a literal
+    if (call->caller->getKind() != NODE_IDENTIFIER) {
+        call->caller = this->fold(call->caller);
+        return call;
+    }
+    if (!constantArgs) {
+        return call;
+    }
+
+    Value callee = this->knownConstant(static_cast<Iden*>(call->caller));
+    if (!callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION) || !static_cast<NativeFunctionValue*>(callee.asObject())->pure) {
+        return call;
+    }
+
+    // A call that fails (e.g. a wrong number of arguments) is left to fail at runtime
+    Value result;
+    try {
+        result = static_cast<NativeFunctionValue*>(callee.asObject())->call(ArgumentSpan(args.data(), args.size()), this->globals);
+    } catch (const std::runtime_error&) {
+        return call;
+    }
+
+    Expression* literal = this->makeLiteral(result);
+    if (literal == nullptr) {
+        return call;
+    }
+    this->eliminated += 1 + call->args.size();
+    return literal;
+}
+
+/**
+ * Fold an expression bottom-up.
+ *
+ * @param expr The expression, may be nullptr.
+ * @return The expression to use in its place.
+ */
+Expression* ConstantFolder::fold(Expression* expr) {
+    if (expr == nullptr) {
+        return nullptr;
+    }
+
+    switch (expr->getKind()) {
+    case NODE_IDENTIFIER: {
+        Value value = this->knownConstant(static_cast<Iden*>(expr));
+        Expression* literal = value.isEmpty() ? nullptr : this->makeLiteral(value);
+        if (literal == nullptr) {
+            return expr;
+        }
+        this->propagated++;
+        return literal;
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        binop->left = this->fold(binop->left);
+        binop->right = this->fold(binop->right);
+        Value left = this->literalValue(binop->left);
+        Value right = this->literalValue(binop->right);
+        if (left.isEmpty() || right.isEmpty()) {
+            return binop;
+        }
+
+        // The interpreter's own operators give the result, errors such as division by zero stay at runtime
+        Value result;
+        try {
+            result = evaluateNumericBinaryExpression(left, right, binop->oper);
+        } catch (const std::runtime_error&) {
+            return binop;
+        }
+        Expression* literal = this->makeLiteral(result);
+        if (literal == nullptr) {
+            return binop;
+        }
+        this->eliminated += 2;
+        return literal;
+    }
+    case NODE_ASSIGNMENTEXPRESSION: {
+        // The target is left alone, assigning to a constant must still fail
+        AssignmentExpression* assignment = static_cast<AssignmentExpression*>(expr);
+        assignment->value = this->fold(assignment->value);
+        return assignment;
+    }
+    case NODE_MEMBEREXPRESSION: {
+        MemberExpression* member = static_cast<MemberExpression*>(expr);
+        member->object = this->fold(member->object);
+        // obj.key names a property, not a variable
+        if (member->computed) {
+            member->property = this->fold(member->property);
+        }
+        return member;
+    }
+    case NODE_OBJECTLITERAL:
+        for (auto prop : static_cast<ObjectLiteral*>(expr)->properties) {
+            prop->value = this->fold(prop->value);
+        }
+        return expr;
+    case NODE_CALLEXPRESSION:
+        return this->foldCall(static_cast<CallExpression*>(expr));
+    default:
+        return expr;
+    }
+}
+
+void ConstantFolder::foldBody(std::vector<Statement*>& body) {
+    for (auto& stmt : body) {
+        stmt = this->foldStatement(stmt);
+    }
+}
+
+// Fold a body that runs in an environment of its own
+void ConstantFolder::foldScopedBody(std::vector<Statement*>& body, int frameSize) {
+    this->frames.emplace_back(frameSize, Value::empty());
+    this->foldBody(body);
+    this->frames.pop_back();
+}
+
+/**
+ * Fold a statement. Frames are entered wherever evaluation creates an
+ * environment, so that the depth and slot of a resolved identifier lead
+ * to the frame of its declaration. Function bodies are folded where they
+ * are declared and only see the constants declared before them.
+ *
+ * @param stmt The statement.
+ * @return The statement to use in its place.
+ */
+Statement* ConstantFolder::foldStatement(Statement* stmt) {
+    switch (stmt->getKind()) {
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+        declaration->expressionValue = this->fold(declaration->expressionValue);
+        if (!declaration->constant || declaration->expressionValue == nullptr) {
+            return stmt;
+        }
+        Value value = this->literalValue(declaration->expressionValue);
+        if (value.isEmpty()) {
+            return stmt;
+        }
+        if (declaration->slot >= 0 && !this->frames.empty()) {
+            std::vector<Value>& frame = this->frames.back();
+            if ((size_t)declaration->slot >= frame.size()) {
+                frame.resize(declaration->slot + 1, Value::empty());
+            }
+            frame[declaration->slot] = value;
+        } else if (declaration->slot < 0 && this->frames.empty()) {
+            this->constants[declaration->symbol] = value;
+        }
+        return stmt;
+    }
+    case NODE_FUNCTIONDECLARATION: {
+        FunctionDeclaration* declaration = static_cast<FunctionDeclaration*>(stmt);
+        if (declaration->resolved) {
+            this->foldScopedBody(declaration->body, declaration->frameSize);
+        }
+        return stmt;
+    }
+    case NODE_IFEXPRESSION: {
+        IfStatement* ifStmt = static_cast<IfStatement*>(stmt);
+        ifStmt->test = this->fold(ifStmt->test);
+        this->foldScopedBody(ifStmt->body, ifStmt->bodyFrameSize);
+        this->foldScopedBody(ifStmt->alternate, ifStmt->alternateFrameSize);
+        return stmt;
+    }
+    case NODE_LOOPSTATEMENT: {
+        LoopStatement* loop = static_cast<LoopStatement*>(stmt);
+        if (loop->loopScope) {
+            this->frames.emplace_back(loop->loopFrameSize, Value::empty());
+        }
+        if (loop->init != nullptr) {
+            loop->init = this->foldStatement(loop->init);
+        }
+        loop->test = this->fold(loop->test);
+        loop->update = this->fold(loop->update);
+        if (loop->bodyScope) {
+            this->foldScopedBody(loop->body, loop->bodyFrameSize);
+        } else {
+            this->foldBody(loop->body);
+        }
+        if (loop->loopScope) {
+            this->frames.pop_back();
+        }
+        return stmt;
+    }
+    case NODE_PROGRAM:
+        return stmt;
+    default:
+        return this->fold(static_cast<Expression*>(stmt));
+    }
+}
+
+uint64_t ConstantFolder::foldProgram(Program& program) {
+    this->foldBody(program.body);
+    runtimeStats().foldedNodes += this->eliminated;
+    runtimeStats().propagatedConstants += this->propagated;
+    return this->eliminated;
+}
+
+uint64_t foldConstants(Program& program, Environment* globals) {
+    return ConstantFolder(globals, program.arena.get()).foldProgram(program);
+}
@@ -0,0 +1,60 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "environment.h"
+#include "stats.h"
+
+// Zlaganje konstant v AST pred izvajanjem
+// Binarne izraze z literali izracuna z istimi funkcijami kot interpreter,
+// identifikatorje konstant z literalno vrednostjo nadomesti z literalom
+// in poklice ciste vgrajene funkcije, ce so vsi argumenti konstante.
+// Tece po razresitvi: okolja sledi po globini in rezah, ki jih doloci resolver,
+// zato konstanto vidi le koda, ki v programu stoji za njeno deklaracijo.
+// Izrazi, katerih izracun vrze napako ali vrne null, ostanejo nespremenjeni.
+
+class ConstantFolder {
+  private:
+    // Globalno okolje z vgrajenimi konstantami in funkcijami
+    Environment* globals;
+
+    // Arena programa, v kateri nastanejo novi literali
+    AstArena* arena;
+
+    // Znane vrednosti konstant po rezah okolij, ki jih ustvari izvajanje
+    // Neznane reze imajo vrednost Value::empty()
+    std::vector<std::vector<Value>> frames = {};
+
+    // Globalne konstante programa, deklarirane do trenutnega stavka
+    std::unordered_map<Symbol, Value> constants = {};
+
+    // Stevilo odstranjenih vozlisc in vstavljenih konstant
+    uint64_t eliminated = 0;
+    uint64_t propagated = 0;
+
+    void foldBody(std::vector<Statement*>& body);
+    void foldScopedBody(std::vector<Statement*>& body, int frameSize);
+    Statement* foldStatement(Statement* stmt);
+    Expression* fold(Expression* expr);
+    Expression* foldCall(CallExpression* call);
+
+    // Vrednost konstante, na katero kaze identifikator, ali Value::empty()
+    Value knownConstant(Iden* iden);
+
+    // Vrednost literala ali Value::empty(), ce izraz ni literal
+    Value literalValue(Expression* expr);
+
+    // Literal z dano vrednostjo ali nullptr, ce vrednosti ni mogoce zapisati z literalom
+    Expression* makeLiteral(Value value);
+
+  public:
+    ConstantFolder(Environment* globals, AstArena* arena);
+
+    // Zlozi konstante v programu in vrne stevilo odstranjenih vozlisc
+    uint64_t foldProgram(Program& program);
+};
+
+// Zlozi konstante v programu, ki se bo izvedel v globalnem okolju globals
+// Stevce pristeje statistiki izvajalnika
+uint64_t foldConstants(Program& program, Environment* globals);
+
+#endif
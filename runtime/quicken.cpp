@@ -0,0 +1,30 @@
+#include "quicken.h"
+#include "interpreter.h"
+
+/**
+ * Evaluate a binary expression outside its specialized path. The first
+ * execution decides whether the node is specialized for numbers; a
+ * specialized node that sees anything else falls back to the generic
+ * path for good, so a polymorphic site does not flip back and forth.
+ * Division by zero also ends up here, but keeps the specialization.
+ *
+ * @param binop The binary expression.
+ * @param left The value of the left operand.
+ * @param right The value of the right operand.
+ * @return The result of the binary expression.
+ */
+Value evaluateBinarySlow(BinaryExpression* binop, Value left, Value right) {
+    bool numbers = left.isNumber() && right.isNumber();
+    if (binop->quickening == QUICKEN_NONE) {
+        binop->quickening = numbers ? QUICKEN_NUMBER : QUICKEN_GENERIC;
+        if (numbers) {
+            runtimeStats().quickenedSites++;
+        } else {
+            runtimeStats().genericSites++;
+        }
+    } else if (binop->quickening == QUICKEN_NUMBER && !numbers) {
+        binop->quickening = QUICKEN_GENERIC;
+        runtimeStats().despecializedSites++;
+    }
+    return evaluateNumericBinaryExpression(left, right, binop->oper);
+}
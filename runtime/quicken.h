@@ -0,0 +1,65 @@
+#ifndef QUICKEN_H
+#define QUICKEN_H
+
+#include "values.h"
+#include "../frontend/ast.h"
+
+#include <cmath>
+
+// Specializacija binarnih izrazov (quickening)
+// Ob prvi izvedbi si izraz zapomni, ali sta bila oba operanda stevili.
+// Specializiran izraz preveri le tipa in racuna neposredno s stevili.
+// Ob drugacnih tipih se trajno vrne na splosno pot (despecializacija).
+// Uporabljata ga drevesni interpreter in evalvator s skladom.
+//
+// Vozlisce se ne zamenja s specializiranim vozliscem, kot je obicajno pri
+// quickeningu, ampak nosi stanje v polju BinaryExpression::quickening.
+// Na binarne izraze kazejo starsi v AST, resolver, prevajalnik za VM in
+// zaprtja ter zlaganje konstant, zato bi zamenjava vozlisca zahtevala
+// popravljanje vseh teh kazalcev. Polje stane en bajt in eno primerjavo.
+
+// Splosna pot: specializira ali despecializira izraz in izracuna rezultat
+Value evaluateBinarySlow(BinaryExpression* binop, Value left, Value right);
+
+// Vrednost binarnega izraza z ze izracunanima operandoma
+inline Value evaluateQuickenedBinary(BinaryExpression* binop, Value left, Value right) {
+    if (binop->quickening == QUICKEN_NUMBER && left.isNumber() && right.isNumber()) {
+        double l = left.asNumber();
+        double r = right.asNumber();
+        switch (binop->oper) {
+        case OP_ADD:
+            return MK_NUMBER(l + r);
+        case OP_SUBTRACT:
+            return MK_NUMBER(l - r);
+        case OP_MULTIPLY:
+            return MK_NUMBER(l * r);
+        case OP_DIVIDE:
+            if (r != 0.0) {
+                return MK_NUMBER(l / r);
+            }
+            break;
+        case OP_MODULO:
+            if (r != 0.0) {
+                return MK_NUMBER(std::fmod(l, r));
+            }
+            break;
+        case OP_EQUALS:
+            return MK_BOOL(l == r);
+        case OP_NOT_EQUALS:
+            return MK_BOOL(l != r);
+        case OP_LESS:
+            return MK_BOOL(l < r);
+        case OP_GREATER:
+            return MK_BOOL(l > r);
+        case OP_LESS_EQUALS:
+            return MK_BOOL(l <= r);
+        case OP_GREATER_EQUALS:
+            return MK_BOOL(l >= r);
+        default:
+            break;
+        }
+    }
+    return evaluateBinarySlow(binop, left, right);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "shape.h"
+#include "stats.h"
+#include "../frontend/ast.h"
+
+Shape::Shape() : parent(nullptr), key(NO_SYMBOL), count(0) {}
+
+Shape::Shape(Shape* parent, Symbol key) : parent(parent), key(key), count(parent->count + 1) {
+    runtimeStats().shapes++;
+}
+
+Shape* Shape::root() {
+    // Leaked on purpose, like every shape: caches hold plain pointers to shapes
+    static Shape* empty = new Shape();
+    return empty;
+}
+
+/**
+ * Find the slot of a key. Small shapes walk their chain of parents, which
+ * is as fast as hashing for a handful of keys; larger ones build a table once.
+ *
+ * @param key The symbol of the property's name.
+ * @return The slot holding the property, or -1 if objects of this shape do not have it.
+ */
+int Shape::lookup(Symbol key) const {
+    if (this->count <= LINEAR_LOOKUP) {
+        for (const Shape* shape = this; shape->count > 0; shape = shape->parent) {
+            if (shape->key == key) {
+                return (int)shape->count - 1;
+            }
+        }
+        return -1;
+    }
+
+    if (!this->table) {
+        this->table = std::make_unique<std::unordered_map<Symbol, uint32_t>>();
+        this->table->reserve(this->count);
+        for (const Shape* shape = this; shape->count > 0; shape = shape->parent) {
+            this->table->emplace(shape->key, shape->count - 1);
+        }
+    }
+    auto it = this->table->find(key);
+    return (it != this->table->end()) ? (int)it->second : -1;
+}
+
+/**
+ * Get the shape of an object after adding a key. Adding the same key to
+ * the same shape always gives the same shape, so objects built the same
+ * way share it.
+ *
+ * @param key The symbol of the new property, which this shape must not have.
+ * @return The shape with the key in the next slot.
+ */
+Shape* Shape::withProperty(Symbol key) {
+    auto it = this->transitions.find(key);
+    if (it != this->transitions.end()) {
+        return it->second.get();
+    }
+    Shape* next = new Shape(this, key);
+    this->transitions.emplace(key, std::unique_ptr<Shape>(next));
+    return next;
+}
+
+/**
+ * Get the shape of the objects created by a literal. It is computed on the
+ * first evaluation and stored in the literal, together with the slot of
+ * every property; a repeated key reuses the slot of its first occurrence.
+ *
+ * @param literal The object literal.
+ * @return The shape of the objects the literal creates.
+ */
+Shape* literalShape(ObjectLiteral* literal) {
+    if (literal->shape != nullptr) {
+        return literal->shape;
+    }
+
+    Shape* shape = Shape::root();
+    for (auto prop : literal->properties) {
+        int slot = shape->lookup(prop->symbol);
+        if (slot < 0) {
+            shape = shape->withProperty(prop->symbol);
+            slot = (int)shape->size() - 1;
+        }
+        prop->slot = (uint32_t)slot;
+    }
+    literal->shape = shape;
+    return shape;
+}
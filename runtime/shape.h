@@ -0,0 +1,55 @@
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include "../frontend/symbols.h"
+
+#include <memory>
+
+class ObjectLiteral;
+
+// Oblika (skriti razred) objekta: zaporedje kljucev in reza vsakega kljuca
+// Objekti z istimi kljuci v istem vrstnem redu si delijo obliko,
+// zato predpomnilnik lastnosti preverja le obliko in bere rezo neposredno.
+// Oblike tvorijo drevo prehodov s praznim korenom in se nikoli ne sprostijo.
+class Shape {
+  private:
+    // Do te velikosti se kljuc isce po verigi starsev, pri vecjih oblikah v tabeli
+    static constexpr uint32_t LINEAR_LOOKUP = 8;
+
+    Shape* const parent;
+
+    // Zadnji dodani kljuc, njegova reza je count - 1
+    const Symbol key;
+    const uint32_t count;
+
+    // Prehodi v oblike z enim kljucem vec
+    std::unordered_map<Symbol, std::unique_ptr<Shape>> transitions = {};
+
+    // Tabela kljuc -> reza, zgrajena ob prvem iskanju v veliki obliki
+    mutable std::unique_ptr<std::unordered_map<Symbol, uint32_t>> table;
+
+    Shape();
+    Shape(Shape* parent, Symbol key);
+
+  public:
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
+
+    // Oblika praznega objekta
+    static Shape* root();
+
+    // Stevilo rez objekta s to obliko
+    uint32_t size() const { return this->count; }
+
+    // Reza kljuca ali -1, ce ga oblika nima
+    int lookup(Symbol key) const;
+
+    // Oblika z dodanim kljucem, ki ga ta oblika se nima
+    Shape* withProperty(Symbol key);
+};
+
+// Koncna oblika objektov, ustvarjenih z literalom
+// Ob prvem klicu doloci tudi reze vseh lastnosti literala
+Shape* literalShape(ObjectLiteral* literal);
+
+#endif
@@ -0,0 +1,411 @@
+#include "stackeval.h"
+
+StackEvaluator::StackEvaluator(size_t maxDepth) : maxDepth(maxDepth) {}
+
+void StackEvaluator::pushNode(Statement* node, Environment* env) {
+    const std::shared_ptr<AstArena>* arena = this->tasks.back().arena;
+    this->tasks.push_back({node, nullptr, env, arena, MK_NULL(), 0, false});
+}
+
+void StackEvaluator::pushBody(const std::vector<Statement*>* body, Environment* env, const std::shared_ptr<AstArena>* arena, Value function, bool functionBody) {
+    this->tasks.push_back({nullptr, body, env, arena, function, 0, functionBody});
+}
+
+// Whether an expression is made only of literals, identifiers and binary operators
+static bool isSimple(Statement* node) {
+    switch (node->getKind()) {
+    case NODE_NUMERICLITERAL:
+    case NODE_BOOLEANLITERAL:
+    case NODE_STRINGLITERAL:
+    case NODE_IDENTIFIER:
+        return true;
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(node);
+        return binop->unboxed || (isSimple(binop->left) && isSimple(binop->right));
+    }
+    default:
+        return false;
+    }
+}
+
+// Evaluate an expression for which isSimple holds
+static Value evaluateSimple(Statement* node, Environment* env) {
+    switch (node->getKind()) {
+    case NODE_NUMERICLITERAL:
+        return MK_NUMBER(static_cast<NumericLiteral*>(node)->value);
+    case NODE_BOOLEANLITERAL:
+        return MK_BOOL(static_cast<BooleanLiteral*>(node)->value);
+    case NODE_STRINGLITERAL:
+        return MK_INTERNED_STRING(static_cast<StringLiteral*>(node)->symbol);
+    case NODE_IDENTIFIER:
+        return evaluateIdentifier(static_cast<Iden*>(node), env);
+    default: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(node);
+        if (binop->unboxed) {
+            return evaluateUnboxedBinary(binop, env);
+        }
+        Value left = evaluateSimple(binop->left, env);
+        if (left.isNumber()) {
+            return evaluateQuickenedBinary(binop, left, evaluateSimple(binop->right, env));
+        }
+        // The left operand must survive a collection triggered while evaluating the right one
+        Root leftRoot(left);
+        Value right = evaluateSimple(binop->right, env);
+        return evaluateQuickenedBinary(binop, left, right);
+    }
+    }
+}
+
+/**
+ * Evaluate a child node of the current task. Expressions without calls
+ * are evaluated on the spot: their recursion is bounded by the nesting
+ * in the source, not by the script's call depth. Everything else becomes
+ * a new task. Either way the value of the child is on the value stack
+ * before the current task continues.
+ *
+ * @param node The child node.
+ * @param env The environment to evaluate it in.
+ * @return True if the value is already on the value stack, false if a task was pushed.
+ */
+bool StackEvaluator::evaluateChild(Statement* node, Environment* env) {
+    if (isSimple(node)) {
+        this->values.push_back(evaluateSimple(node, env));
+        return true;
+    }
+    this->pushNode(node, env);
+    return false;
+}
+
+/**
+ * Evaluate the next statement of a body. The value of every statement
+ * but the last is discarded; an empty body yields null.
+ */
+void StackEvaluator::stepBody(Task& task) {
+    size_t count = task.body->size();
+    if (count == 0) {
+        this->values.push_back(MK_NULL());
+    } else if (task.step < count) {
+        if (task.step > 0) {
+            this->values.pop_back();
+        }
+        Statement* stmt = (*task.body)[task.step++];
+        this->evaluateChild(stmt, task.env);
+        return;
+    }
+
+    if (task.functionBody) {
+        this->depth--;
+    }
+    this->tasks.pop_back();
+}
+
+/**
+ * Evaluate a call: the arguments, then the callee, then either call a
+ * native function directly or replace the call by the body of the
+ * function. A tail call also removes the body it was called from.
+ */
+void StackEvaluator::stepCall(Task& task) {
+    CallExpression* call = static_cast<CallExpression*>(task.node);
+    size_t argc = call->args.size();
+
+    // Arguments without calls are evaluated in one go; a pushed task runs before this one continues
+    while (task.step < argc) {
+        Expression* arg = call->args[task.step++];
+        if (!this->evaluateChild(arg, task.env)) {
+            return;
+        }
+    }
+    if (task.step == argc) {
+        task.step++;
+        if (!this->evaluateChild(call->caller, task.env)) {
+            return;
+        }
+    }
+    if (task.step == argc + 2) {
+        // The function returned, its value is on the value stack
+        this->tasks.pop_back();
+        return;
+    }
+
+    Value callee = this->values.back();
+    size_t argsStart = this->values.size() - argc - 1;
+
+    if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+        NativeFunctionValue* fn = static_cast<NativeFunctionValue*>(callee.asObject());
+        // The arguments stay on the value stack, which a native function cannot grow
+        Value result = fn->call(ArgumentSpan(this->values.data() + argsStart, argc), task.env);
+        this->values.resize(argsStart);
+        this->values.push_back(result);
+        this->tasks.pop_back();
+        return;
+    }
+    if (!callee.isObjectOf(VALUETYPE_FUNCTION)) {
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    }
+
+    FunctionValue* func = static_cast<FunctionValue*>(callee.asObject());
+
+    // A tail call returns straight to the caller of the current function,
+    // so the current function's body and the branches leading to the call go away
+    size_t frame = this->tasks.size() - 1;
+    if (call->tail) {
+        while (frame > 0 && !this->tasks[frame].functionBody) {
+            frame--;
+        }
+    }
+    bool tail = call->tail && this->tasks[frame].functionBody;
+
+    if (!tail && this->depth >= this->maxDepth) {
+        throw std::runtime_error("Maximum call depth of " + std::to_string(this->maxDepth) + " exceeded.");
+    }
+
+    Environment* scope = bindArguments(func, this->values.data() + argsStart, argc);
+    this->values.resize(argsStart);
+
+    if (tail) {
+        // The body of the current function is replaced by the body of the callee
+        this->tasks.resize(frame + 1);
+        this->tasks[frame] = {nullptr, &func->prototype->body, scope, &func->prototype->arena, callee, 0, true};
+        return;
+    }
+    task.step++;
+    this->depth++;
+    this->pushBody(&func->prototype->body, scope, &func->prototype->arena, callee, true);
+}
+
+/**
+ * Evaluate a loop: the initializer once, then the test, the body and the
+ * update until the test is no longer true. The value of the latest
+ * iteration (null before the first one) stays on the value stack.
+ */
+void StackEvaluator::stepLoop(Task& task) {
+    LoopStatement* loop = static_cast<LoopStatement*>(task.node);
+
+    switch (task.step) {
+    case 0:
+        // The loop task keeps the environment of the loop header for its whole run
+        if (loop->loopScope) {
+            task.env = heap().allocate<Environment>(task.env, loop->loopFrameSize);
+        }
+        this->values.push_back(MK_NULL());
+        if (loop->init != nullptr) {
+            task.step = 1;
+            this->evaluateChild(loop->init, task.env);
+            return;
+        }
+        break;
+    case 1:
+        // Discard the value of the initializer
+        this->values.pop_back();
+        break;
+    case 2: {
+        Value test = this->values.back();
+        this->values.pop_back();
+        if (!test.isBool() || !test.asBool()) {
+            this->tasks.pop_back();
+            return;
+        }
+        // The body replaces the value of the previous iteration
+        this->values.pop_back();
+        task.step = 3;
+        Environment* scope = loop->bodyScope ? heap().allocate<Environment>(task.env, loop->bodyFrameSize) : task.env;
+        this->pushBody(&loop->body, scope, task.arena, MK_NULL(), false);
+        return;
+    }
+    case 3:
+        if (loop->update != nullptr) {
+            task.step = 4;
+            this->evaluateChild(loop->update, task.env);
+            return;
+        }
+        break;
+    case 4:
+        // Discard the value of the update
+        this->values.pop_back();
+        break;
+    }
+
+    task.step = 2;
+    if (loop->test == nullptr) {
+        this->values.push_back(MK_BOOL(true));
+    } else {
+        this->evaluateChild(loop->test, task.env);
+    }
+}
+
+Value StackEvaluator::run(Program& program, Environment* env) {
+    this->tasks.clear();
+    this->values.clear();
+    this->depth = 0;
+
+    // Intermediate values and the environments and functions of pending tasks are roots
+    Root valuesRoot(this->values);
+    Root tasksRoot(&this->tasks, [](void* pointer, Heap& heap) {
+        for (const Task& task : *static_cast<std::vector<Task>*>(pointer)) {
+            heap.markEnvironment(task.env);
+            heap.markValue(task.function);
+        }
+    });
+
+    this->pushBody(&program.body, env, &program.arena, MK_NULL(), false);
+
+    while (!this->tasks.empty()) {
+        // Pushing a task may move the stack, so the reference is only used before that
+        Task& task = this->tasks.back();
+        if (task.body != nullptr) {
+            this->stepBody(task);
+            continue;
+        }
+
+        Statement* node = task.node;
+        switch (node->getKind()) {
+        case NODE_STRINGLITERAL:
+            this->values.push_back(MK_INTERNED_STRING(static_cast<StringLiteral*>(node)->symbol));
+            this->tasks.pop_back();
+            break;
+        case NODE_BINARYEXPRESSION: {
+            BinaryExpression* binop = static_cast<BinaryExpression*>(node);
+            if (task.step == 0) {
+                task.step = 1;
+                if (!this->evaluateChild(binop->left, task.env)) {
+                    break;
+                }
+            }
+            if (task.step == 1) {
+                task.step = 2;
+                if (!this->evaluateChild(binop->right, task.env)) {
+                    break;
+                }
+            }
+            {
+                Value right = this->values.back();
+                this->values.pop_back();
+                this->values.back() = evaluateQuickenedBinary(binop, this->values.back(), right);
+                this->tasks.pop_back();
+            }
+            break;
+        }
+        case NODE_ASSIGNMENTEXPRESSION: {
+            AssignmentExpression* assignment = static_cast<AssignmentExpression*>(node);
+            if (assignment->assigne->getKind() != NODE_IDENTIFIER) {
+                throw std::runtime_error("Invalid left-hand-side inside assignment expression.");
+            }
+            if (task.step == 0) {
+                task.step = 1;
+                this->evaluateChild(assignment->value, task.env);
+                break;
+            }
+            Iden* iden = static_cast<Iden*>(assignment->assigne);
+            Value value = this->values.back();
+            if (iden->depth >= 0) {
+                if (iden->constant) {
+                    throw std::runtime_error("Cannot modify constant variable: " + iden->value);
+                }
+                task.env->assignSlot(iden->depth, iden->slot, value, iden->value);
+            } else {
+                assignNameCached(iden, task.env, value);
+            }
+            this->tasks.pop_back();
+            break;
+        }
+        case NODE_VARIABLEDECLARATION: {
+            VariableDeclaration* declaration = static_cast<VariableDeclaration*>(node);
+            if (task.step == 0) {
+                task.step = 1;
+                this->evaluateChild(declaration->expressionValue, task.env);
+                break;
+            }
+            if (declaration->slot >= 0) {
+                task.env->declareSlot(declaration->slot, this->values.back(), declaration->identifier);
+            } else {
+                task.env->declareVariable(declaration->symbol, this->values.back(), declaration->constant);
+            }
+            this->tasks.pop_back();
+            break;
+        }
+        case NODE_FUNCTIONDECLARATION:
+            this->values.push_back(declareFunction(static_cast<FunctionDeclaration*>(node), task.env, *task.arena));
+            this->tasks.pop_back();
+            break;
+        case NODE_OBJECTLITERAL: {
+            // The object under construction stays on the value stack below the property values
+            ObjectLiteral* obj = static_cast<ObjectLiteral*>(node);
+            if (task.step == 0) {
+                this->values.push_back(Value::object(heap().allocate<ObjectValue>(literalShape(obj))));
+            } else {
+                Value value = this->values.back();
+                this->values.pop_back();
+                static_cast<ObjectValue*>(this->values.back().asObject())->setSlot(obj->properties[task.step - 1]->slot, value);
+            }
+            if (task.step < obj->properties.size()) {
+                Property* prop = obj->properties[task.step++];
+                if (prop->value == nullptr) {
+                    this->values.push_back(task.env->lookupVariable(prop->symbol));
+                } else {
+                    this->evaluateChild(prop->value, task.env);
+                }
+            } else {
+                this->tasks.pop_back();
+            }
+            break;
+        }
+        case NODE_MEMBEREXPRESSION: {
+            MemberExpression* member = static_cast<MemberExpression*>(node);
+            if (task.step == 0) {
+                task.step = 1;
+                this->evaluateChild(member->object, task.env);
+            } else if (member->computed && task.step == 1) {
+                task.step = 2;
+                this->evaluateChild(member->property, task.env);
+            } else if (member->computed) {
+                Value key = this->values.back();
+                this->values.pop_back();
+                this->values.back() = getProperty(this->values.back(), computedPropertyKey(key));
+                this->tasks.pop_back();
+            } else {
+                this->values.back() = getPropertyCached(member, this->values.back());
+                this->tasks.pop_back();
+            }
+            break;
+        }
+        case NODE_IFEXPRESSION: {
+            IfStatement* ifStmt = static_cast<IfStatement*>(node);
+            if (task.step == 0) {
+                task.step = 1;
+                if (!this->evaluateChild(ifStmt->test, task.env)) {
+                    break;
+                }
+            }
+            Value test = this->values.back();
+            this->values.pop_back();
+            if (!test.isBool()) {
+                this->values.push_back(MK_NULL());
+                this->tasks.pop_back();
+                break;
+            }
+            // The if statement becomes the body of the taken branch
+            bool taken = test.asBool();
+            task.env = heap().allocate<Environment>(task.env, taken ? ifStmt->bodyFrameSize : ifStmt->alternateFrameSize);
+            task.body = taken ? &ifStmt->body : &ifStmt->alternate;
+            task.step = 0;
+            break;
+        }
+        case NODE_CALLEXPRESSION:
+            this->stepCall(task);
+            break;
+        case NODE_LOOPSTATEMENT:
+            this->stepLoop(task);
+            break;
+        case NODE_PROGRAM:
+            task.body = &static_cast<Program*>(node)->body;
+            task.step = 0;
+            break;
+        default:
+            throw std::runtime_error("This AST node has not yet been set up for interpretation: " + node->getKindName());
+        }
+    }
+
+    Value result = this->values.empty() ? MK_NULL() : this->values.back();
+    this->values.clear();
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef STACKEVAL_H
+#define STACKEVAL_H
+
+#include "interpreter.h"
+
+// Evalvator z eksplicitnim skladom
+// Vozlisca AST se ne evalvirajo z rekurzijo v C++, ampak kot naloge na skladu
+// na kopici, zato globina rekurzije skripte ni omejena s skladom niti.
+// Globino klicev omejuje nastavljiva meja, ob kateri skripta dobi napako.
+
+class StackEvaluator {
+  private:
+    // Naloga na skladu: vozlisce ali telo, ki se evalvira, in korak evalvacije
+    struct Task {
+        Statement* node;
+
+        // Telo (zaporedje stavkov), ce naloga ne evalvira posameznega vozlisca
+        const std::vector<Statement*>* body;
+
+        Environment* env;
+
+        // Arena z vozlisci, ki se trenutno izvajajo
+        const std::shared_ptr<AstArena>* arena;
+
+        // Funkcija, katere telo se izvaja (samo za telesa funkcij)
+        Value function;
+
+        uint32_t step;
+        bool functionBody;
+    };
+
+    // Sklad nalog in sklad vmesnih vrednosti
+    std::vector<Task> tasks = {};
+    std::vector<Value> values = {};
+
+    // Najvecja globina klicev in trenutna globina
+    size_t maxDepth;
+    size_t depth = 0;
+
+    void pushNode(Statement* node, Environment* env);
+    void pushBody(const std::vector<Statement*>* body, Environment* env, const std::shared_ptr<AstArena>* arena, Value function, bool functionBody);
+
+    // Evalvira podizraz: izraze brez klicev takoj, ostalo kot novo nalogo
+    // Vrne true, ce je vrednost ze na skladu vrednosti
+    bool evaluateChild(Statement* node, Environment* env);
+
+    void stepBody(Task& task);
+    void stepCall(Task& task);
+    void stepLoop(Task& task);
+
+  public:
+    static constexpr size_t DEFAULT_MAX_DEPTH = 1000000;
+
+    StackEvaluator(size_t maxDepth = DEFAULT_MAX_DEPTH);
+
+    // Izvedi program v danem okolju
+    Value run(Program& program, Environment* env);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "stats.h"
+#include "../frontend/symbols.h"
+
+RuntimeStats& runtimeStats() {
+    static RuntimeStats stats;
+    return stats;
+}
+
+/**
+ * Print one kind of cache as hits, misses and the hit rate.
+ *
+ * @param out The stream to print to.
+ * @param name The name of the cache.
+ * @param hits The number of lookups answered by the cache.
+ * @param misses The number of lookups that took the slow path.
+ */
+static void printCache(std::ostream& out, const char* name, uint64_t hits, uint64_t misses) {
+    uint64_t total = hits + misses;
+    double rate = (total == 0) ? 0.0 : 100.0 * (double)hits / (double)total;
+    out << "  " << name << ": " << hits << " zadetkov, " << misses << " zgresitev (" << rate << " %)" << std::endl;
+}
+
+void printRuntimeStats(std::ostream& out) {
+    const RuntimeStats& stats = runtimeStats();
+    out << "Predpomnilniki:" << std::endl;
+    printCache(out, "imena", stats.nameHits, stats.nameMisses);
+    printCache(out, "lastnosti", stats.propertyHits, stats.propertyMisses);
+    out << "Oblike objektov: " << stats.shapes << std::endl;
+    out << "Simboli: " << symbols().size() << std::endl;
+    out << "Specializirani binarni izrazi: " << stats.quickenedSites << " specializiranih, "
+        << stats.despecializedSites << " despecializiranih, "
+        << (stats.quickenedSites - stats.despecializedSites) << " ostalo specializiranih, "
+        << stats.genericSites << " splosnih" << std::endl;
+    out << "Sklepanje o tipih: " << stats.numericSlots << " stevilskih rez, " << stats.unboxedExpressions << " nepakiranih binarnih izrazov" << std::endl;
+    out << "Stopnje izvajanja: " << stats.tierUps << " prevedenih funkcij, " << stats.loopTierUps << " prevedenih zank, "
+        << (double)stats.compileNanoseconds / 1e6 << " ms prevajanja" << std::endl;
+    out << "Strojna koda: " << stats.jitFunctions << " prevedenih funkcij, " << stats.jitRejected << " zavrnjenih, "
+        << stats.jitCalls << " klicev, " << stats.jitBailouts << " izstopov, "
+        << stats.jitVerified << " preverjenih, " << stats.jitMismatches << " neujemanj" << std::endl;
+    out << "Zlaganje konstant: " << stats.foldedNodes << " odstranjenih vozlisc, " << stats.propagatedConstants << " vstavljenih konstant" << std::endl;
+}
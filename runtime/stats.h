@@ -0,0 +1,51 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <ostream>
+
+// Stevci izvajalnika, izpisani z --stats
+struct RuntimeStats {
+    // Predpomnilniki iskanja spremenljivk po imenu
+    uint64_t nameHits = 0;
+    uint64_t nameMisses = 0;
+
+    // Predpomnilniki branja lastnosti objektov
+    uint64_t propertyHits = 0;
+    uint64_t propertyMisses = 0;
+
+    // Stevilo ustvarjenih oblik objektov
+    uint64_t shapes = 0;
+
+    // Zlaganje konstant: odstranjena vozlisca in identifikatorji, nadomesceni z literali
+    uint64_t foldedNodes = 0;
+    uint64_t propagatedConstants = 0;
+
+    // Binarni izrazi, specializirani za stevila, in tisti, ki so specializacijo izgubili
+    uint64_t quickenedSites = 0;
+    uint64_t despecializedSites = 0;
+    uint64_t genericSites = 0;
+
+    // Sklepanje o tipih: stevilske reze in nepakirani binarni izrazi
+    uint64_t numericSlots = 0;
+    uint64_t unboxedExpressions = 0;
+
+    // Vecstopenjsko izvajanje: prevedene vroce funkcije in zanke ter cas prevajanja
+    uint64_t tierUps = 0;
+    uint64_t loopTierUps = 0;
+    uint64_t compileNanoseconds = 0;
+
+    // Strojna koda: prevedene in zavrnjene funkcije, klici, izstopi v interpreter in preverjanja
+    uint64_t jitFunctions = 0;
+    uint64_t jitRejected = 0;
+    uint64_t jitCalls = 0;
+    uint64_t jitBailouts = 0;
+    uint64_t jitVerified = 0;
+    uint64_t jitMismatches = 0;
+};
+
+RuntimeStats& runtimeStats();
+
+void printRuntimeStats(std::ostream& out);
+
+#endif
@@ -0,0 +1,85 @@
+#include "tiering.h"
+#include "jit.h"
+
+#include <chrono>
+
+TierSettings& tierSettings() {
+    static TierSettings settings;
+    return settings;
+}
+
+// Nanoseconds elapsed since start, added to the compile time in the stats
+static void recordCompileTime(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    runtimeStats().compileNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+/**
+ * Count a call of a function running in the tree-walker. When the calls
+ * and back-edges of its declaration reach the threshold, the body is
+ * compiled once for all closures of the declaration.
+ *
+ * @param func The function being called.
+ * @return True if the function has a compiled body to run.
+ */
+bool countCall(FunctionValue* func) {
+    FunctionDeclaration* declaration = func->prototype->declaration;
+    if (declaration->closureBody) {
+        return true;
+    }
+    if (++declaration->calls + declaration->backEdges < tierSettings().threshold) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    declaration->closureBody = ClosureCompiler(func->prototype->arena).compileFunction(declaration);
+    if (jitSettings().enabled) {
+        compileJit(func);
+    }
+    recordCompileTime(start);
+    runtimeStats().tierUps++;
+    return true;
+}
+
+/**
+ * Count a back-edge of a loop running in the tree-walker. A loop in a
+ * function adds to the hotness of the function, so a function that is
+ * called rarely but loops a lot is compiled on its next call as well.
+ *
+ * @param loop The loop that finished an iteration.
+ * @param arena The arena of the running program, for functions declared in the loop.
+ * @return The compiled iterations of the loop, or nullptr while it is cold.
+ */
+ClosureLoop* countBackEdge(LoopStatement* loop, const std::shared_ptr<AstArena>& arena) {
+    if (!loop->compiled) {
+        FunctionDeclaration* function = loop->function;
+        uint32_t hotness = (function != nullptr) ? ++function->backEdges + function->calls : ++loop->backEdges;
+        if (hotness < tierSettings().threshold) {
+            return nullptr;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        loop->compiled = ClosureCompiler(arena).compileLoopContinuation(loop);
+        recordCompileTime(start);
+        runtimeStats().loopTierUps++;
+    }
+    return loop->compiled.get();
+}
+
+/**
+ * Call a function that has tiered up. Numeric functions with machine
+ * code run natively; any other call, and any call the machine code
+ * bails out of, runs the compiled closures.
+ *
+ * @param func The function being called.
+ * @param args The evaluated arguments.
+ * @param argc The number of arguments.
+ * @return The value of the call.
+ */
+Value callHot(FunctionValue* func, const Value* args, size_t argc) {
+    Value result = MK_NULL();
+    if (runJit(func, args, argc, result)) {
+        return result;
+    }
+    return callClosure(func, args, argc);
+}
@@ -0,0 +1,37 @@
+#ifndef TIERING_H
+#define TIERING_H
+
+#include "closures.h"
+
+// Vecstopenjsko izvajanje drevesnega interpreterja
+// Funkcije in zanke se zacnejo izvajati z evaluate(). Klici funkcije in povratni
+// skoki zank v njenem telesu stejejo njeno vrocino. Ko doseze prag, se telo prevede
+// v zaprtja (runtime/closures.h) in naslednji klici tecejo prevedeni.
+// Vroca zanka se prevede ze med izvajanjem in od naslednje ponovitve dalje tece
+// prevedena, saj je vse njeno stanje v okolju. Zanke na vrhnjem nivoju programa
+// stejejo svoje povratne skoke same. Z --jit se vroca stevilska funkcija
+// prevede se v strojno kodo.
+
+struct TierSettings {
+    // Vklopljeno le za drevesni interpreter
+    bool enabled = false;
+
+    // Prag vrocine (klici in povratni skoki)
+    uint32_t threshold = 1000;
+};
+
+TierSettings& tierSettings();
+
+// Steje klic funkcije, ob prehodu praga prevede telo
+// Vrne true, ce naj se funkcija izvede prevedena
+bool countCall(FunctionValue* func);
+
+// Steje povratni skok zanke, ob prehodu praga prevede njene ponovitve
+// Vrne prevedeno zanko ali nullptr, ce zanka se ni vroca
+ClosureLoop* countBackEdge(LoopStatement* loop, const std::shared_ptr<AstArena>& arena);
+
+// Poklici vroco funkcijo: s strojno kodo (runtime/jit.h), ce jo ima in so
+// argumenti stevila, sicer s prevedenimi zaprtji
+Value callHot(FunctionValue* func, const Value* args, size_t argc);
+
+#endif
@@ -0,0 +1,595 @@
+#include "transpiler.h"
+#include "shape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Name of an operator constant in the generated code
+static const char* operatorName(OperatorType op) {
+    switch (op) {
+    case OP_ADD:
+        return "OP_ADD";
+    case OP_SUBTRACT:
+        return "OP_SUBTRACT";
+    case OP_MULTIPLY:
+        return "OP_MULTIPLY";
+    case OP_DIVIDE:
+        return "OP_DIVIDE";
+    case OP_MODULO:
+        return "OP_MODULO";
+    case OP_EQUALS:
+        return "OP_EQUALS";
+    case OP_NOT_EQUALS:
+        return "OP_NOT_EQUALS";
+    case OP_LESS:
+        return "OP_LESS";
+    case OP_GREATER:
+        return "OP_GREATER";
+    case OP_LESS_EQUALS:
+        return "OP_LESS_EQUALS";
+    case OP_GREATER_EQUALS:
+        return "OP_GREATER_EQUALS";
+    default:
+        throw CompileError("Unknown binary operator.");
+    }
+}
+
+// A C++ string literal; bytes outside printable ASCII become octal escapes
+static std::string stringLiteral(const std::string& value) {
+    std::string literal = "\"";
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += (char)c;
+        } else if (c >= 0x20 && c < 0x7F) {
+            literal += (char)c;
+        } else {
+            char escape[5];
+            std::snprintf(escape, sizeof(escape), "\\%03o", c);
+            literal += escape;
+        }
+    }
+    return literal + "\"";
+}
+
+// A C++ double literal with the exact value (hexadecimal floating point)
+static std::string numberLiteral(double value) {
+    if (std::isnan(value)) {
+        return "std::nan(\"\")";
+    }
+    if (std::isinf(value)) {
+        return value < 0 ? "-HUGE_VAL" : "HUGE_VAL";
+    }
+    char literal[64];
+    std::snprintf(literal, sizeof(literal), "%a", value);
+    return literal;
+}
+
+size_t CppTranspiler::name(const std::string& value) {
+    auto found = this->nameIndex.find(value);
+    if (found != this->nameIndex.end()) {
+        return found->second;
+    }
+    size_t index = this->names.size();
+    this->names.push_back(value);
+    this->nameIndex.emplace(value, index);
+    return index;
+}
+
+void CppTranspiler::line(const std::string& text) {
+    *this->out << std::string(4 * this->indent, ' ') << text << "\n";
+}
+
+std::string CppTranspiler::fresh(const char* prefix) {
+    return prefix + std::to_string(this->temps++);
+}
+
+// Store an intermediate value in the rooted temporaries of the function and return it
+std::string CppTranspiler::temp(const std::string& expr) {
+    std::string variable = "t[" + std::to_string(this->slots++) + "]";
+    this->line(variable + " = " + expr + ";");
+    return variable;
+}
+
+/**
+ * Translate a resolved depth to the number of environments that really
+ * exist between the current one and the target, skipping the scopes that
+ * are not created (see elidable).
+ *
+ * @param depth The depth computed by the resolver.
+ * @return The depth in the generated code.
+ */
+int CppTranspiler::depth(int depth) {
+    int real = depth;
+    for (int i = 0; i < depth && i < (int)this->scopes.size(); i++) {
+        if (this->scopes[this->scopes.size() - 1 - i]) {
+            real--;
+        }
+    }
+    return real;
+}
+
+/**
+ * A block scope without slots and without declarations of its own holds
+ * no bindings, so every lookup passes straight through it. Such a scope
+ * is not created; resolved depths inside it are adjusted instead.
+ */
+bool CppTranspiler::elidable(const std::vector<Statement*>& statements, int frameSize) {
+    if (frameSize != 0) {
+        return false;
+    }
+    for (auto stmt : statements) {
+        if (stmt->getKind() == NODE_VARIABLEDECLARATION || stmt->getKind() == NODE_FUNCTIONDECLARATION) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CppTranspiler::assign(const std::string& target, const std::string& expr) {
+    this->line(target.empty() ? expr + ";" : target + " = " + expr + ";");
+}
+
+/**
+ * Emit the evaluation of an expression. Literals are returned as C++
+ * expressions; everything else is evaluated into a rooted temporary at
+ * this point, so side effects keep the interpreter's order.
+ *
+ * @param expr The expression.
+ * @return A C++ expression for its value.
+ */
+std::string CppTranspiler::value(Expression* expr) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL:
+        return "MK_NUMBER(" + numberLiteral(static_cast<NumericLiteral*>(expr)->value) + ")";
+    case NODE_BOOLEANLITERAL:
+        return static_cast<BooleanLiteral*>(expr)->value ? "MK_BOOL(true)" : "MK_BOOL(false)";
+    case NODE_STRINGLITERAL:
+        return "MK_INTERNED_STRING(SYMBOLS[" + std::to_string(this->name(static_cast<StringLiteral*>(expr)->value)) + "])";
+    case NODE_IDENTIFIER: {
+        Iden* iden = static_cast<Iden*>(expr);
+        if (iden->depth >= 0) {
+            return this->temp(this->env + "->lookupSlot(" + std::to_string(this->depth(iden->depth)) + ", " + std::to_string(iden->slot) +
+                              ", NAMES[" + std::to_string(this->name(iden->value)) + "])");
+        }
+        size_t site = this->globals++;
+        this->initializers.push_back("GLOBALS[" + std::to_string(site) + "] = {SYMBOLS[" + std::to_string(this->name(iden->value)) +
+                                     "], &NAMES[" + std::to_string(this->name(iden->value)) + "]};");
+        return this->temp("aotLookupName(GLOBALS[" + std::to_string(site) + "], " + this->env + ")");
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        std::string left = this->value(binop->left);
+        std::string right = this->value(binop->right);
+        return this->temp(std::string("aotBinary<") + operatorName(binop->oper) + ">(" + left + ", " + right + ")");
+    }
+    case NODE_ASSIGNMENTEXPRESSION:
+        return this->assignment(static_cast<AssignmentExpression*>(expr));
+    case NODE_CALLEXPRESSION:
+        return this->call(static_cast<CallExpression*>(expr));
+    case NODE_MEMBEREXPRESSION:
+        return this->member(static_cast<MemberExpression*>(expr));
+    case NODE_OBJECTLITERAL:
+        return this->object(static_cast<ObjectLiteral*>(expr));
+    default:
+        throw CompileError("Cannot transpile node " + expr->getKindName() + ".");
+    }
+}
+
+/**
+ * Emit a call like evaluateCallExpression: the arguments and then the
+ * callee go into an argument frame that lives only for the call.
+ */
+std::string CppTranspiler::call(CallExpression* call) {
+    std::string result = "t[" + std::to_string(this->slots++) + "]";
+    std::string frame = this->fresh("frame");
+    this->line("{");
+    this->indent++;
+    this->line("ArgumentFrame " + frame + ";");
+    for (auto arg : call->args) {
+        this->line(frame + ".push(" + this->value(arg) + ");");
+    }
+    this->line(frame + ".push(" + this->value(call->caller) + ");");
+    this->line(result + " = aotCall(" + frame + ", " + std::to_string(call->args.size()) + ", " + this->env + ");");
+    this->indent--;
+    this->line("}");
+    return result;
+}
+
+std::string CppTranspiler::member(MemberExpression* member) {
+    std::string object = this->value(member->object);
+    if (member->computed) {
+        std::string key = this->value(member->property);
+        return this->temp("getProperty(" + object + ", computedPropertyKey(" + key + "))");
+    }
+    if (member->property->getKind() != NODE_IDENTIFIER) {
+        throw CompileError("Property name is not an identifier.");
+    }
+    size_t site = this->properties++;
+    this->initializers.push_back("PROPERTIES[" + std::to_string(site) + "].key = SYMBOLS[" +
+                                 std::to_string(this->name(static_cast<Iden*>(member->property)->value)) + "];");
+    return this->temp("aotGetProperty(PROPERTIES[" + std::to_string(site) + "], " + object + ")");
+}
+
+// Same checks and order as evaluateAssignment: the target kind first, constness after the value
+std::string CppTranspiler::assignment(AssignmentExpression* assignment) {
+    if (assignment->assigne->getKind() != NODE_IDENTIFIER) {
+        return this->temp("aotError(" + stringLiteral("Invalid left-hand-side inside assignment expression.") + ")");
+    }
+    Iden* iden = static_cast<Iden*>(assignment->assigne);
+    std::string value = this->value(assignment->value);
+    if (iden->depth >= 0) {
+        if (iden->constant) {
+            return this->temp("aotError(" + stringLiteral("Cannot modify constant variable: " + iden->value) + ")");
+        }
+        return this->temp(this->env + "->assignSlot(" + std::to_string(this->depth(iden->depth)) + ", " + std::to_string(iden->slot) + ", " +
+                          value + ", NAMES[" + std::to_string(this->name(iden->value)) + "])");
+    }
+    size_t site = this->globals++;
+    this->initializers.push_back("GLOBALS[" + std::to_string(site) + "] = {SYMBOLS[" + std::to_string(this->name(iden->value)) +
+                                 "], &NAMES[" + std::to_string(this->name(iden->value)) + "]};");
+    return this->temp("aotAssignName(GLOBALS[" + std::to_string(site) + "], " + this->env + ", " + value + ")");
+}
+
+/**
+ * Emit an object literal like evaluateObject. The shape is built once at
+ * startup with the same rule as literalShape, which also gives the slot
+ * of every property here.
+ */
+std::string CppTranspiler::object(ObjectLiteral* object) {
+    literalShape(object);
+    size_t shape = this->shapes++;
+    std::string keys;
+    for (auto prop : object->properties) {
+        keys += (keys.empty() ? "SYMBOLS[" : ", SYMBOLS[") + std::to_string(this->name(prop->key)) + "]";
+    }
+    this->initializers.push_back("SHAPES[" + std::to_string(shape) + "] = aotShape({" + keys + "});");
+
+    std::string result = this->fresh("object");
+    this->line("ObjectValue* " + result + " = heap().allocate<ObjectValue>(SHAPES[" + std::to_string(shape) + "]);");
+    std::string value = this->temp("Value::object(" + result + ")");
+    for (auto prop : object->properties) {
+        std::string property = (prop->value == nullptr)
+            ? this->temp(this->env + "->lookupVariable(SYMBOLS[" + std::to_string(this->name(prop->key)) + "])")
+            : this->value(prop->value);
+        this->line(result + "->setSlot(" + std::to_string(prop->slot) + ", " + property + ");");
+    }
+    return value;
+}
+
+/**
+ * Emit the body of a function as a separate C++ function and register
+ * its declaration for startup.
+ *
+ * @param declaration The function declaration.
+ * @return The index of the declaration in FUNCTIONS.
+ */
+size_t CppTranspiler::function(FunctionDeclaration* declaration) {
+    size_t index = this->functions++;
+    std::string function = "function" + std::to_string(index);
+
+    std::ostringstream* outer = this->out;
+    int indent = this->indent;
+    std::string env = this->env;
+    size_t slots = this->slots;
+
+    std::ostringstream code;
+    this->out = &code;
+    this->indent = 1;
+    this->env = "env";
+    this->slots = 0;
+
+    // The environment of the call, created by callClosure
+    this->scopes.push_back(false);
+    this->tailBody(declaration->body);
+    this->scopes.pop_back();
+
+    std::string signature = declaration->name + "(";
+    for (size_t i = 0; i < declaration->parameters.size(); i++) {
+        signature += (i == 0 ? "" : ", ") + declaration->parameters[i];
+    }
+    this->definitions.push_back("// funkcija " + signature + ")\n" +
+                                this->definition("static bool " + function + "(Environment*& env, Value& result, ArgumentFrame& args, Value& callee)", code.str()));
+
+    this->out = outer;
+    this->indent = indent;
+    this->env = env;
+    this->slots = slots;
+
+    std::string parameters;
+    std::string parameterSymbols;
+    for (size_t i = 0; i < declaration->parameters.size(); i++) {
+        std::string index = std::to_string(this->name(declaration->parameters[i]));
+        parameters += (i == 0 ? "NAMES[" : ", NAMES[") + index + "]";
+        parameterSymbols += (i == 0 ? "SYMBOLS[" : ", SYMBOLS[") + index + "]";
+    }
+    std::string nameIndex = std::to_string(this->name(declaration->name));
+    this->initializers.push_back("FUNCTIONS[" + std::to_string(index) + "] = aotFunction(NAMES[" + nameIndex + "], SYMBOLS[" + nameIndex +
+                                 "], {" + parameters + "}, {" + parameterSymbols + "}, " + std::to_string(declaration->slot) + ", " +
+                                 (declaration->resolved ? "true" : "false") + ", " + std::to_string(declaration->frameSize) + ", " +
+                                 function + ");");
+    return index;
+}
+
+// A C++ function with the given signature and body, which declares the temporaries the body uses
+std::string CppTranspiler::definition(const std::string& signature, const std::string& code) {
+    std::string temps = (this->slots == 0) ? "" : "    AotTemps<" + std::to_string(this->slots) + "> t;\n";
+    return signature + " {\n" + temps + code + "}\n";
+}
+
+void CppTranspiler::statement(Statement* stmt, const std::string& target) {
+    switch (stmt->getKind()) {
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+        if (declaration->expressionValue == nullptr) {
+            throw CompileError("Declaration without a value.");
+        }
+        std::string value = this->value(declaration->expressionValue);
+        std::string nameIndex = std::to_string(this->name(declaration->identifier));
+        if (declaration->slot >= 0) {
+            this->assign(target, this->env + "->declareSlot(" + std::to_string(declaration->slot) + ", " + value + ", NAMES[" + nameIndex + "])");
+        } else {
+            this->assign(target, this->env + "->declareVariable(SYMBOLS[" + nameIndex + "], " + value + ", " +
+                                     (declaration->constant ? "true" : "false") + ")");
+        }
+        return;
+    }
+    case NODE_FUNCTIONDECLARATION: {
+        size_t index = this->function(static_cast<FunctionDeclaration*>(stmt));
+        this->assign(target, "declareFunction(FUNCTIONS[" + std::to_string(index) + "], " + this->env + ", aotArena())");
+        return;
+    }
+    case NODE_IFEXPRESSION:
+        this->ifStatement(static_cast<IfStatement*>(stmt), target);
+        return;
+    case NODE_LOOPSTATEMENT:
+        this->loop(static_cast<LoopStatement*>(stmt), target);
+        return;
+    default: {
+        std::string value = this->value(static_cast<Expression*>(stmt));
+        if (!target.empty()) {
+            this->assign(target, value);
+        }
+        return;
+    }
+    }
+}
+
+void CppTranspiler::body(const std::vector<Statement*>& statements, const std::string& target) {
+    if (statements.empty() && !target.empty()) {
+        this->assign(target, "MK_NULL()");
+    }
+    for (size_t i = 0; i < statements.size(); i++) {
+        this->statement(statements[i], (i + 1 == statements.size()) ? target : "");
+    }
+}
+
+void CppTranspiler::scopedBody(const std::vector<Statement*>& statements, int frameSize, const std::string& target) {
+    if (this->elidable(statements, frameSize)) {
+        this->scopes.push_back(true);
+        this->body(statements, target);
+        this->scopes.pop_back();
+        return;
+    }
+
+    std::string scope = this->fresh("env");
+    this->line("Environment* " + scope + " = heap().allocate<Environment>(" + this->env + ", " + std::to_string(frameSize) + ");");
+    this->line("Root " + scope + "_root(" + scope + ");");
+    std::string outer = this->env;
+    this->env = scope;
+    this->scopes.push_back(false);
+    this->body(statements, target);
+    this->scopes.pop_back();
+    this->env = outer;
+}
+
+// Same semantics as evaluateIfStatement: a test that is not a boolean gives null
+void CppTranspiler::ifStatement(IfStatement* ifStmt, const std::string& target) {
+    std::string test = this->value(ifStmt->test);
+    this->line("if (" + test + ".isBool()) {");
+    this->indent++;
+    this->line("if (" + test + ".asBool()) {");
+    this->indent++;
+    this->scopedBody(ifStmt->body, ifStmt->bodyFrameSize, target);
+    this->indent--;
+    this->line("} else {");
+    this->indent++;
+    this->scopedBody(ifStmt->alternate, ifStmt->alternateFrameSize, target);
+    this->indent--;
+    this->line("}");
+    this->indent--;
+    if (target.empty()) {
+        this->line("}");
+        return;
+    }
+    this->line("} else {");
+    this->indent++;
+    this->assign(target, "MK_NULL()");
+    this->indent--;
+    this->line("}");
+}
+
+// Same semantics as evaluateLoopStatement; the value of the loop is the value of its last iteration
+void CppTranspiler::loop(LoopStatement* loop, const std::string& target) {
+    this->line("{");
+    this->indent++;
+    std::string outer = this->env;
+    if (loop->loopScope) {
+        std::string scope = this->fresh("env");
+        this->line("Environment* " + scope + " = heap().allocate<Environment>(" + this->env + ", " + std::to_string(loop->loopFrameSize) + ");");
+        this->line("Root " + scope + "_root(" + scope + ");");
+        this->env = scope;
+        this->scopes.push_back(false);
+    }
+    if (!target.empty()) {
+        this->assign(target, "MK_NULL()");
+    }
+    if (loop->init != nullptr) {
+        this->statement(loop->init, "");
+    }
+
+    this->line("while (true) {");
+    this->indent++;
+    if (loop->test != nullptr) {
+        std::string test = this->value(loop->test);
+        this->line("if (!" + test + ".isBool() || !" + test + ".asBool()) {");
+        this->line("    break;");
+        this->line("}");
+    }
+    if (loop->bodyScope) {
+        this->scopedBody(loop->body, loop->bodyFrameSize, target);
+    } else {
+        this->body(loop->body, target);
+    }
+    if (loop->update != nullptr) {
+        this->value(loop->update);
+    }
+    this->indent--;
+    this->line("}");
+
+    if (loop->loopScope) {
+        this->scopes.pop_back();
+    }
+    this->env = outer;
+    this->indent--;
+    this->line("}");
+}
+
+void CppTranspiler::tailBody(const std::vector<Statement*>& statements) {
+    if (statements.empty()) {
+        this->line("result = MK_NULL();");
+        this->line("return false;");
+        return;
+    }
+    for (size_t i = 0; i + 1 < statements.size(); i++) {
+        this->statement(statements[i], "");
+    }
+    this->tail(statements.back());
+}
+
+// The branch of an if statement in tail position continues in its own environment
+void CppTranspiler::tailScope(const std::vector<Statement*>& statements, int frameSize) {
+    bool elided = this->elidable(statements, frameSize);
+    if (!elided) {
+        this->line("env = heap().allocate<Environment>(env, " + std::to_string(frameSize) + ");");
+    }
+    this->scopes.push_back(elided);
+    this->tailBody(statements);
+    this->scopes.pop_back();
+}
+
+/**
+ * Emit the last statement of a function body. Same semantics as
+ * ClosureCompiler::compileTail: a tail call hands its arguments and
+ * callee to callClosure, and an if statement continues in the
+ * environment of the taken branch.
+ */
+void CppTranspiler::tail(Statement* stmt) {
+    if (stmt->getKind() == NODE_CALLEXPRESSION && static_cast<CallExpression*>(stmt)->tail) {
+        CallExpression* call = static_cast<CallExpression*>(stmt);
+        for (auto arg : call->args) {
+            this->line("args.push(" + this->value(arg) + ");");
+        }
+        this->line("callee = " + this->value(call->caller) + ";");
+        this->line("return true;");
+        return;
+    }
+
+    if (stmt->getKind() == NODE_IFEXPRESSION) {
+        IfStatement* ifStmt = static_cast<IfStatement*>(stmt);
+        std::string test = this->value(ifStmt->test);
+        this->line("if (!" + test + ".isBool()) {");
+        this->line("    result = MK_NULL();");
+        this->line("    return false;");
+        this->line("}");
+        this->line("if (" + test + ".asBool()) {");
+        this->indent++;
+        this->tailScope(ifStmt->body, ifStmt->bodyFrameSize);
+        this->indent--;
+        this->line("}");
+        this->tailScope(ifStmt->alternate, ifStmt->alternateFrameSize);
+        return;
+    }
+
+    this->statement(stmt, "result");
+    this->line("return false;");
+}
+
+/**
+ * Transpile a whole program. The top-level statements and the startup
+ * code are split into functions of at most AOT_CHUNK statements, which
+ * keeps long scripts within what the C++ compiler optimizes quickly.
+ *
+ * @param program The resolved program.
+ * @param source The name of the source file, for the header comment.
+ * @return The C++ translation unit.
+ */
+std::string CppTranspiler::transpile(Program& program, const std::string& source) {
+    const size_t AOT_CHUNK = 256;
+
+    std::ostringstream main;
+    this->env = "env";
+    size_t parts = 0;
+    for (size_t first = 0; first < program.body.size(); first += AOT_CHUNK) {
+        std::vector<Statement*> statements(program.body.begin() + first,
+                                           program.body.begin() + std::min(first + AOT_CHUNK, program.body.size()));
+        std::ostringstream code;
+        this->out = &code;
+        this->indent = 1;
+        this->slots = 0;
+        this->body(statements, "");
+        main << this->definition("static void program" + std::to_string(parts++) + "(Environment* env)", code.str()) << "\n";
+    }
+
+    std::ostringstream unit;
+    unit << "// Prevedeno iz " << source << " z slo++ --emit-cpp\n";
+    unit << "// g++ -std=c++17 -O2 -I<repo> program.cpp <repo>/frontend/*.cpp <repo>/runtime/*.cpp\n";
+    unit << "#include \"runtime/aot.h\"\n\n";
+
+    unit << "static const std::vector<std::string> NAMES = {";
+    for (size_t i = 0; i < this->names.size(); i++) {
+        unit << (i == 0 ? "" : ", ") << stringLiteral(this->names[i]);
+    }
+    unit << "};\n";
+    unit << "static std::vector<Symbol> SYMBOLS(NAMES.size());\n";
+    unit << "static std::vector<AotName> GLOBALS(" << this->globals << ");\n";
+    unit << "static std::vector<AotProperty> PROPERTIES(" << this->properties << ");\n";
+    unit << "static std::vector<Shape*> SHAPES(" << this->shapes << ");\n";
+    unit << "static std::vector<FunctionDeclaration*> FUNCTIONS(" << this->functions << ");\n\n";
+
+    for (size_t i = 0; i < this->functions; i++) {
+        unit << "static bool function" << i << "(Environment*& env, Value& result, ArgumentFrame& args, Value& callee);\n";
+    }
+
+    size_t initializerParts = 0;
+    for (size_t first = 0; first < this->initializers.size(); first += AOT_CHUNK) {
+        unit << "\nstatic void initialize" << initializerParts++ << "() {\n";
+        for (size_t i = first; i < std::min(first + AOT_CHUNK, this->initializers.size()); i++) {
+            unit << "    " << this->initializers[i] << "\n";
+        }
+        unit << "}\n";
+    }
+    unit << "\nstatic void initialize() {\n";
+    unit << "    for (size_t i = 0; i < NAMES.size(); i++) {\n";
+    unit << "        SYMBOLS[i] = symbols().intern(NAMES[i]);\n";
+    unit << "    }\n";
+    for (size_t i = 0; i < initializerParts; i++) {
+        unit << "    initialize" << i << "();\n";
+    }
+    unit << "}\n";
+
+    for (const std::string& definition : this->definitions) {
+        unit << "\n" << definition;
+    }
+    unit << "\n" << main.str();
+    unit << "static void program(Environment* env) {\n";
+    for (size_t i = 0; i < parts; i++) {
+        unit << "    program" << i << "(env);\n";
+    }
+    unit << "}\n";
+    unit << "\nint main() {\n";
+    unit << "    return aotMain(initialize, program);\n";
+    unit << "}\n";
+    return unit.str();
+}
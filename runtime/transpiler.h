@@ -0,0 +1,87 @@
+#ifndef TRANSPILER_H
+#define TRANSPILER_H
+
+#include "compiler.h"
+
+#include <sstream>
+#include <unordered_map>
+
+// Prevajanje programa v samostojno enoto C++ (--emit-cpp)
+// Vsak stavek in izraz se zapise kot koda C++, ki klice iste funkcije izvajalnika
+// kot interpreter: okolja in reze, imenovane vezave s predpomnilnikom, binarne
+// operacije, klice in objekte (runtime/aot.h). Telo vsake funkcije postane
+// funkcija C++, ki jo izvaja callClosure. Vmesne vrednosti so v tabeli t, ki je
+// en koren zbiralnika smeti na klic. Okolja blokov brez rez in deklaracij se ne
+// ustvarijo. Enota se prevede skupaj z izvajalnikom:
+//     g++ -std=c++17 -O2 -I<repo> program.cpp <repo>/frontend/*.cpp <repo>/runtime/*.cpp
+// Program mora biti razresen (resolveProgram) in je lahko zlozen (foldConstants).
+
+class CppTranspiler {
+  private:
+    // Imena spremenljivk, lastnosti in nizov: indeks v NAMES in SYMBOLS prevedene enote
+    std::vector<std::string> names = {};
+    std::unordered_map<std::string, size_t> nameIndex = {};
+
+    // Stevilo predpomnilnikov imen in lastnosti, oblik in funkcij
+    size_t globals = 0;
+    size_t properties = 0;
+    size_t shapes = 0;
+    size_t functions = 0;
+
+    // Vrstice funkcije initialize() in definicije teles funkcij
+    std::vector<std::string> initializers = {};
+    std::vector<std::string> definitions = {};
+
+    // Koda funkcije, ki se trenutno zapisuje
+    std::ostringstream* out = nullptr;
+    int indent = 0;
+
+    // Spremenljivka C++ s trenutnim okoljem
+    std::string env = "env";
+
+    // Stevec imen okolij, objektov in okvirjev argumentov
+    size_t temps = 0;
+
+    // Stevilo vmesnih vrednosti t[i] funkcije, ki se trenutno zapisuje
+    size_t slots = 0;
+
+    // Okolja od zunanjega do trenutnega; true za okolje bloka, ki se ne ustvari
+    std::vector<bool> scopes = {};
+
+    size_t name(const std::string& value);
+    void line(const std::string& text);
+    std::string fresh(const char* prefix);
+    std::string temp(const std::string& expr);
+    void assign(const std::string& target, const std::string& expr);
+    std::string definition(const std::string& signature, const std::string& code);
+
+    // Globina razresene spremenljivke brez okolij, ki se ne ustvarijo
+    int depth(int depth);
+    bool elidable(const std::vector<Statement*>& statements, int frameSize);
+
+    std::string value(Expression* expr);
+    std::string call(CallExpression* call);
+    std::string member(MemberExpression* member);
+    std::string assignment(AssignmentExpression* assignment);
+    std::string object(ObjectLiteral* object);
+    size_t function(FunctionDeclaration* declaration);
+
+    // Stavek, katerega vrednost se zapise v target (prazen target vrednost zavrze)
+    void statement(Statement* stmt, const std::string& target);
+    void body(const std::vector<Statement*>& statements, const std::string& target);
+    void scopedBody(const std::vector<Statement*>& statements, int frameSize, const std::string& target);
+    void ifStatement(IfStatement* ifStmt, const std::string& target);
+    void loop(LoopStatement* loop, const std::string& target);
+
+    // Telo funkcije, ki klic v repnem polozaju preda callClosure
+    void tailBody(const std::vector<Statement*>& statements);
+    void tailScope(const std::vector<Statement*>& statements, int frameSize);
+    void tail(Statement* stmt);
+
+  public:
+    // Vrne enoto C++ za razresen program, source je ime izvorne datoteke
+    // Vozlisca, ki jih ni mogoce prevesti, vrzejo CompileError
+    std::string transpile(Program& program, const std::string& source);
+};
+
+#endif
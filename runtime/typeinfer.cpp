@@ -0,0 +1,317 @@
+#include "typeinfer.h"
+
+#include <cmath>
+
+// Operators whose result is a number when both operands are numbers
+static bool isArithmetic(OperatorType op) {
+    return op == OP_ADD || op == OP_SUBTRACT || op == OP_MULTIPLY || op == OP_DIVIDE || op == OP_MODULO;
+}
+
+bool TypeInference::isNumber(Expression* expr) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL:
+        return true;
+    case NODE_IDENTIFIER: {
+        Iden* iden = static_cast<Iden*>(expr);
+        if (iden->depth < 0 || (size_t)iden->depth >= this->scopes.size()) {
+            return false;
+        }
+        int scope = this->scopes[this->scopes.size() - 1 - iden->depth];
+        return scope >= 0 && this->numeric[scope][iden->slot];
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        return isArithmetic(binop->oper) && this->isNumber(binop->left) && this->isNumber(binop->right);
+    }
+    default:
+        return false;
+    }
+}
+
+void TypeInference::define(int depth, int slot, bool isNumber) {
+    if (depth < 0 || (size_t)depth >= this->scopes.size()) {
+        return;
+    }
+    int scope = this->scopes[this->scopes.size() - 1 - depth];
+    if (scope >= 0 && !isNumber && this->numeric[scope][slot]) {
+        this->numeric[scope][slot] = false;
+        this->changed = true;
+    }
+}
+
+/**
+ * Enter an environment created while running the unit. Environments of
+ * the unit itself get the same index in every walk and start out with all
+ * slots assumed numeric; environments of nested functions are not tracked.
+ *
+ * @param size The number of slots of the environment.
+ */
+void TypeInference::enterScope(int size) {
+    if (this->nested > 0) {
+        this->scopes.push_back(-1);
+        return;
+    }
+    size_t index = this->nextScope++;
+    if (index == this->numeric.size()) {
+        this->numeric.emplace_back(size, true);
+    }
+    this->scopes.push_back((int)index);
+}
+
+void TypeInference::walkBody(std::vector<Statement*>& body) {
+    for (auto stmt : body) {
+        this->walkStatement(stmt);
+    }
+}
+
+void TypeInference::walkScopedBody(std::vector<Statement*>& body, int size) {
+    this->enterScope(size);
+    this->walkBody(body);
+    this->scopes.pop_back();
+}
+
+void TypeInference::walkStatement(Statement* stmt) {
+    switch (stmt->getKind()) {
+    case NODE_VARIABLEDECLARATION: {
+        VariableDeclaration* declaration = static_cast<VariableDeclaration*>(stmt);
+        if (declaration->expressionValue != nullptr) {
+            this->walk(declaration->expressionValue);
+        }
+        if (declaration->slot >= 0) {
+            this->define(0, declaration->slot, declaration->expressionValue != nullptr && this->isNumber(declaration->expressionValue));
+        }
+        break;
+    }
+    case NODE_FUNCTIONDECLARATION: {
+        FunctionDeclaration* declaration = static_cast<FunctionDeclaration*>(stmt);
+        if (declaration->slot >= 0) {
+            this->define(0, declaration->slot, false);
+        }
+        if (!declaration->resolved) {
+            break;
+        }
+        if (this->marking && this->nested == 0) {
+            this->pending.push_back(declaration);
+        }
+
+        // The body may assign variables of this unit whenever the function is called
+        this->nested++;
+        this->walkScopedBody(declaration->body, declaration->frameSize);
+        this->nested--;
+        break;
+    }
+    case NODE_IFEXPRESSION: {
+        IfStatement* ifStmt = static_cast<IfStatement*>(stmt);
+        this->walk(ifStmt->test);
+        this->walkScopedBody(ifStmt->body, ifStmt->bodyFrameSize);
+        this->walkScopedBody(ifStmt->alternate, ifStmt->alternateFrameSize);
+        break;
+    }
+    case NODE_LOOPSTATEMENT: {
+        LoopStatement* loop = static_cast<LoopStatement*>(stmt);
+        if (loop->loopScope) {
+            this->enterScope(loop->loopFrameSize);
+        }
+        if (loop->init != nullptr) {
+            this->walkStatement(loop->init);
+        }
+        if (loop->test != nullptr) {
+            this->walk(loop->test);
+        }
+        if (loop->update != nullptr) {
+            this->walk(loop->update);
+        }
+        if (loop->bodyScope) {
+            this->walkScopedBody(loop->body, loop->bodyFrameSize);
+        } else {
+            this->walkBody(loop->body);
+        }
+        if (loop->loopScope) {
+            this->scopes.pop_back();
+        }
+        break;
+    }
+    case NODE_PROGRAM:
+        break;
+    default:
+        this->walk(static_cast<Expression*>(stmt));
+        break;
+    }
+}
+
+void TypeInference::walk(Expression* expr) {
+    switch (expr->getKind()) {
+    case NODE_ASSIGNMENTEXPRESSION: {
+        AssignmentExpression* assignment = static_cast<AssignmentExpression*>(expr);
+        this->walk(assignment->value);
+        if (assignment->assigne->getKind() == NODE_IDENTIFIER) {
+            Iden* iden = static_cast<Iden*>(assignment->assigne);
+            this->define(iden->depth, iden->slot, this->nested == 0 && this->isNumber(assignment->value));
+        }
+        break;
+    }
+    case NODE_BINARYEXPRESSION: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        this->walk(binop->left);
+        this->walk(binop->right);
+        if (this->marking && !binop->unboxed && binop->oper != OP_NONE && this->isNumber(binop->left) && this->isNumber(binop->right)) {
+            binop->unboxed = true;
+            runtimeStats().unboxedExpressions++;
+        }
+        break;
+    }
+    case NODE_CALLEXPRESSION: {
+        CallExpression* call = static_cast<CallExpression*>(expr);
+        for (auto arg : call->args) {
+            this->walk(arg);
+        }
+        this->walk(call->caller);
+        break;
+    }
+    case NODE_MEMBEREXPRESSION: {
+        MemberExpression* member = static_cast<MemberExpression*>(expr);
+        this->walk(member->object);
+        if (member->computed) {
+            this->walk(member->property);
+        }
+        break;
+    }
+    case NODE_OBJECTLITERAL:
+        for (auto prop : static_cast<ObjectLiteral*>(expr)->properties) {
+            this->walk(prop->value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void TypeInference::walkUnit(std::vector<Statement*>& body, FunctionDeclaration* function) {
+    this->nextScope = 0;
+    this->scopes.clear();
+    if (function != nullptr) {
+        // Parameters hold whatever the caller passes
+        this->enterScope(function->frameSize);
+        for (size_t i = 0; i < function->parameters.size(); i++) {
+            this->numeric[this->scopes.back()][i] = false;
+        }
+    }
+    this->walkBody(body);
+}
+
+/**
+ * Infer the numeric slots of one unit. Each walk may only remove slots
+ * from the assumption, so repeating it until nothing changes reaches the
+ * largest set of slots whose definitions are all numeric given that set.
+ * A final walk then marks the binary expressions over numeric operands.
+ *
+ * @param body The statements of the unit.
+ * @param function The function whose body is analyzed, nullptr for the program.
+ */
+void TypeInference::analyze(std::vector<Statement*>& body, FunctionDeclaration* function) {
+    this->numeric.clear();
+    this->marking = false;
+    do {
+        this->changed = false;
+        this->walkUnit(body, function);
+    } while (this->changed);
+
+    this->marking = true;
+    this->walkUnit(body, function);
+
+    for (const auto& scope : this->numeric) {
+        for (bool slot : scope) {
+            runtimeStats().numericSlots += slot ? 1 : 0;
+        }
+    }
+}
+
+void TypeInference::inferProgram(Program& program) {
+    this->analyze(program.body, nullptr);
+    while (!this->pending.empty()) {
+        FunctionDeclaration* function = this->pending.back();
+        this->pending.pop_back();
+        this->analyze(function->body, function);
+    }
+}
+
+void inferTypes(Program& program) {
+    TypeInference().inferProgram(program);
+}
+
+// Arithmetic on two numbers, division by zero raises the interpreter's errors
+static double arithmetic(OperatorType op, double l, double r) {
+    switch (op) {
+    case OP_ADD:
+        return l + r;
+    case OP_SUBTRACT:
+        return l - r;
+    case OP_MULTIPLY:
+        return l * r;
+    case OP_DIVIDE:
+        if (r == 0.0) {
+            throw std::runtime_error("Deljenje z 0.");
+        }
+        return l / r;
+    default:
+        if (r == 0.0) {
+            throw std::runtime_error("Modulo z 0.");
+        }
+        return std::fmod(l, r);
+    }
+}
+
+/**
+ * Evaluate an expression the inference proved numeric, without boxing
+ * intermediate results or checking their types.
+ *
+ * @param expr A numeric literal, a numeric slot or arithmetic over them.
+ * @param env The environment in which to evaluate the expression.
+ * @return The value of the expression.
+ */
+double evaluateNumber(Expression* expr, Environment* env) {
+    switch (expr->getKind()) {
+    case NODE_NUMERICLITERAL:
+        return static_cast<NumericLiteral*>(expr)->value;
+    case NODE_IDENTIFIER: {
+        // Throws if the variable is not declared yet, otherwise it holds a number
+        Iden* iden = static_cast<Iden*>(expr);
+        return env->lookupSlot(iden->depth, iden->slot, iden->value).asNumber();
+    }
+    default: {
+        BinaryExpression* binop = static_cast<BinaryExpression*>(expr);
+        double l = evaluateNumber(binop->left, env);
+        double r = evaluateNumber(binop->right, env);
+        return arithmetic(binop->oper, l, r);
+    }
+    }
+}
+
+/**
+ * Evaluate a binary expression over two numeric operands. Arithmetic and
+ * comparison are computed on doubles; only the result is boxed.
+ *
+ * @param binop The binary expression, marked unboxed by the inference.
+ * @param env The environment in which to evaluate the expression.
+ * @return The result of the binary expression.
+ */
+Value evaluateUnboxedBinary(BinaryExpression* binop, Environment* env) {
+    double l = evaluateNumber(binop->left, env);
+    double r = evaluateNumber(binop->right, env);
+    switch (binop->oper) {
+    case OP_EQUALS:
+        return MK_BOOL(l == r);
+    case OP_NOT_EQUALS:
+        return MK_BOOL(l != r);
+    case OP_LESS:
+        return MK_BOOL(l < r);
+    case OP_GREATER:
+        return MK_BOOL(l > r);
+    case OP_LESS_EQUALS:
+        return MK_BOOL(l <= r);
+    case OP_GREATER_EQUALS:
+        return MK_BOOL(l >= r);
+    default:
+        return MK_NUMBER(arithmetic(binop->oper, l, r));
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TYPEINFER_H
+#define TYPEINFER_H
+
+#include "environment.h"
+#include "stats.h"
+
+// Staticno sklepanje o tipih lokalnih spremenljivk
+// Enota analize je telo funkcije ali vrhnji nivo programa. Reza okolja enote je
+// stevilska, ce so vse njene definicije (deklaracije in prireditve) stevilski
+// izrazi: literali, stevilske reze in aritmetika nad njimi. Parametri niso
+// stevilski, saj funkcijo lahko poklice kdorkoli. Prireditve iz gnezdenih
+// funkcij in deklaracije funkcij rezo izlocijo. Zacne se z domnevo, da so
+// vse reze stevilske, in jo zmanjsuje do negibne tocke.
+// Binarni izrazi s stevilskima operandoma se oznacijo kot nepakirani
+// (BinaryExpression::unboxed) in se racunajo z double brez preverjanja tipov.
+// Branje reze, ki se ni deklarirana, se vedno vrze napako, zato je prebrana
+// vrednost stevilske reze vedno stevilo.
+
+class TypeInference {
+  private:
+    // Stevilske reze okolij enote, po vrstnem redu okolij v sprehodu
+    std::vector<std::vector<bool>> numeric = {};
+
+    // Okolja na poti sprehoda: indeks v numeric ali -1 za okolje gnezdene funkcije
+    std::vector<int> scopes = {};
+
+    // Naslednji indeks okolja v trenutnem sprehodu
+    size_t nextScope = 0;
+
+    // Globina gnezdenih funkcij znotraj enote
+    int nested = 0;
+
+    // Ali je sprehod zmanjsal domnevo
+    bool changed = false;
+
+    // Zadnji sprehod oznaci izraze in zbere gnezdene funkcije
+    bool marking = false;
+
+    // Funkcije, ki se analizirajo kot samostojne enote
+    std::vector<FunctionDeclaration*> pending = {};
+
+    void analyze(std::vector<Statement*>& body, FunctionDeclaration* function);
+    void walkUnit(std::vector<Statement*>& body, FunctionDeclaration* function);
+    void enterScope(int size);
+    void walkBody(std::vector<Statement*>& body);
+    void walkScopedBody(std::vector<Statement*>& body, int size);
+    void walkStatement(Statement* stmt);
+    void walk(Expression* expr);
+
+    // Zabelezi definicijo reze, ki je stevilska le, ce je isNumber
+    void define(int depth, int slot, bool isNumber);
+
+    // Ali je izraz ob trenutni domnevi vedno stevilo
+    bool isNumber(Expression* expr);
+
+  public:
+    void inferProgram(Program& program);
+};
+
+// Oznaci nepakirane binarne izraze programa in vseh njegovih funkcij
+// Stevce pristeje statistiki izvajalnika
+void inferTypes(Program& program);
+
+// Vrednost stevilskega izraza (literal, stevilska reza ali aritmetika nad njimi)
+double evaluateNumber(Expression* expr, Environment* env);
+
+// Vrednost nepakiranega binarnega izraza
+Value evaluateUnboxedBinary(BinaryExpression* binop, Environment* env);
+
+#endif
@@ -1,11 +1,9 @@
 // values.cpp
 #include "values.h"
 
-RuntimeValue::RuntimeValue() : type(VALUETYPE_NULL), value("null") {}
+#include <algorithm>
 
-RuntimeValue::RuntimeValue(ValueType t, std::string v) : type(t), value(v) {}
-
-std::string RuntimeValue::getTypeName() {
+std::string getTypeName(ValueType type) {
     switch (type) {
         case VALUETYPE_NULL:
             return "null";
@@ -26,36 +24,15 @@ std::string RuntimeValue::getTypeName() {
     return "boolean";
 }
 
-RuntimeValue::~RuntimeValue() {}
-
-NullValue::NullValue() {
-    type = VALUETYPE_NULL;
-    value = "null";
-}
-
-NullValue::~NullValue() {}
-
-BoolValue::BoolValue(bool b) : value(b) {
-    type = VALUETYPE_BOOLEAN;
-    value = b;
-}
-
-void BoolValue::toString() {
-    std::cout << std::boolalpha << this->value << std::endl;
-}
+RuntimeValue::RuntimeValue() : type(VALUETYPE_NULL) {}
 
-BoolValue::~BoolValue() {}
+RuntimeValue::RuntimeValue(ValueType t) : type(t) {}
 
-NumberValue::NumberValue(float val) : value(val) {
-    type = VALUETYPE_NUMBER;
-    value = val;
-}
-
-void NumberValue::toString() {
-    std::cout << this->value;
+std::string RuntimeValue::getTypeName() {
+    return ::getTypeName(type);
 }
 
-NumberValue::~NumberValue() {}
+RuntimeValue::~RuntimeValue() {}
 
 StringValue::StringValue(std::string val) : value(val) {
     type = VALUETYPE_STRING;
@@ -68,33 +45,114 @@ void StringValue::toString() {
 
 StringValue::~StringValue() {}
 
-ObjectValue::ObjectValue() {
-    type = VALUETYPE_OBJECT;
-    properties = std::map<std::string, RuntimeValue*>();
+// Characters that do not fit in the string's inline buffer
+size_t StringValue::extraSize() const {
+    static const size_t inlineCapacity = std::string().capacity();
+    return (this->value.capacity() > inlineCapacity) ? this->value.capacity() + 1 : 0;
 }
-ObjectValue::ObjectValue(std::map<std::string, RuntimeValue*> p) {
+
+ObjectValue::ObjectValue() : ObjectValue(Shape::root()) {}
+
+ObjectValue::ObjectValue(Shape* s) : shape(s), slots(inlineSlots), capacity(INLINE_SLOTS) {
     type = VALUETYPE_OBJECT;
-    properties = p;
+    if (s->size() > INLINE_SLOTS) {
+        this->capacity = s->size();
+        this->overflowSlots.reset(new Value[this->capacity]);
+        this->slots = this->overflowSlots.get();
+    }
 }
 
 ObjectValue::~ObjectValue() {};
 
-RuntimeValue* MK_NUMBER(float n) {
-    return new NumberValue(n);
+Value* ObjectValue::findProperty(Symbol key) {
+    int slot = this->shape->lookup(key);
+    return (slot >= 0) ? &this->slots[slot] : nullptr;
 }
 
-RuntimeValue* MK_STRING(std::string s) {
-    return new StringValue(s);
+/**
+ * Set a property, adding it if the object does not have it yet. A new
+ * property moves the object to the next shape and takes the next slot;
+ * the slots grow by doubling once they no longer fit in the object.
+ *
+ * @param key The symbol of the property's name.
+ * @param value The new value of the property.
+ */
+void ObjectValue::setProperty(Symbol key, Value value) {
+    Value* existing = this->findProperty(key);
+    if (existing != nullptr) {
+        *existing = value;
+        return;
+    }
+
+    uint32_t slot = this->shape->size();
+    if (slot == this->capacity) {
+        size_t before = this->extraSize();
+        uint32_t grown = this->capacity * 2;
+        std::unique_ptr<Value[]> moved(new Value[grown]);
+        std::copy(this->slots, this->slots + slot, moved.get());
+        this->overflowSlots = std::move(moved);
+        this->slots = this->overflowSlots.get();
+        this->capacity = grown;
+        heap().resize(this, before);
+    }
+    this->shape = this->shape->withProperty(key);
+    this->slots[slot] = value;
 }
 
-RuntimeValue* MK_BOOL(bool b) {
-    return new BoolValue(b);
+void ObjectValue::trace(Heap& heap) {
+    for (uint32_t i = 0; i < this->shape->size(); i++) {
+        heap.markValue(this->slots[i]);
+    }
+}
+
+size_t ObjectValue::extraSize() const {
+    return this->overflowSlots ? this->capacity * sizeof(Value) : 0;
 }
 
-RuntimeValue* MK_NULL() {
-    return new NullValue();
+Value MK_STRING(std::string s) {
+    return Value::object(heap().allocate<StringValue>(s));
 }
 
-RuntimeValue* MK_OBJECT(std::map<std::string, RuntimeValue*> obj) {
-    return new ObjectValue(obj);
+Value MK_INTERNED_STRING(Symbol symbol) {
+    // Indexed by symbol; each string is a permanent root once created
+    static std::vector<StringValue*> interned;
+    if (symbol >= interned.size()) {
+        interned.resize(symbols().size(), nullptr);
+    }
+    if (interned[symbol] == nullptr) {
+        StringValue* string = heap().allocate<StringValue>(symbols().name(symbol));
+        string->symbol = symbol;
+        heap().addRoot(string);
+        interned[symbol] = string;
+    }
+    return Value::object(interned[symbol]);
+}
+
+/**
+ * Compare the contents of two strings. Interned strings are unique per
+ * symbol, so two of them are equal only if they are the same object and
+ * their characters never need to be compared.
+ *
+ * @param lhs A string value.
+ * @param rhs A string value.
+ * @return True if both strings hold the same characters.
+ */
+bool stringsEqual(Value lhs, Value rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
+    StringValue* left = static_cast<StringValue*>(lhs.asObject());
+    StringValue* right = static_cast<StringValue*>(rhs.asObject());
+    if (left->symbol != NO_SYMBOL && right->symbol != NO_SYMBOL) {
+        return false;
+    }
+    return left->value == right->value;
+}
+
+Value MK_OBJECT(std::map<std::string, Value> obj) {
+    ObjectValue* object = heap().allocate<ObjectValue>();
+    for (auto& property : obj) {
+        object->setProperty(symbols().intern(property.first), property.second);
+    }
+    return Value::object(object);
 }
@@ -2,7 +2,11 @@
 #define VALUES_H
 
 #include "../frontend/Functions.h"
+#include "gc.h"
+#include "shape.h"
 
+#include <cstdint>
+#include <cstring>
 #include <map>
 
 enum ValueType {
@@ -15,61 +19,147 @@ enum ValueType {
     VALUETYPE_FUNCTION,
 };
 
-class NullValue;
-class NumberValue;
+std::string getTypeName(ValueType type);
 
-class RuntimeValue {
+// Vrednost na kopici (nizi, objekti, funkcije)
+class RuntimeValue : public GcObject {
   public:
     RuntimeValue();
-    RuntimeValue(ValueType t, std::string v);
+    RuntimeValue(ValueType t);
     std::string getTypeName();
     virtual ~RuntimeValue();
     ValueType type;
-    std::string value = "";
 };
 
-class NullValue : public RuntimeValue {
-  public:
-    NullValue();
-    virtual ~NullValue();
-};
+// 64-bitna vrednost (NaN-boxing)
+// Stevila so shranjena neposredno kot double, null in bool kot tihi NaN z oznako,
+// kazalec na vrednost na kopici pa kot tihi NaN s postavljenim predznakom
+class Value {
+  private:
+    static constexpr uint64_t SIGN_BIT = 0x8000000000000000;
+    static constexpr uint64_t QNAN = 0x7ffc000000000000;
+    static constexpr uint64_t CANONICAL_NAN = 0x7ff8000000000000;
 
-class BoolValue : public RuntimeValue {
-  public:
-    BoolValue(bool b = true);
-    virtual ~BoolValue();
-    bool value;
-    void toString();
-};
+    static constexpr uint64_t TAG_NULL = 1;
+    static constexpr uint64_t TAG_FALSE = 2;
+    static constexpr uint64_t TAG_TRUE = 3;
+    static constexpr uint64_t TAG_EMPTY = 4;
+
+    uint64_t bits;
+
+    constexpr explicit Value(uint64_t b) : bits(b) {}
 
-class NumberValue : public RuntimeValue {
   public:
-    NumberValue(float val = 0.0);
-    virtual ~NumberValue();
-    float value;
-    void toString();
+    constexpr Value() : bits(QNAN | TAG_NULL) {}
+
+    static Value number(double d) {
+        uint64_t b;
+        std::memcpy(&b, &d, sizeof(b));
+        // NaN z drugacnim vzorcem bitov bi lahko izgledal kot oznaka
+        return Value((d != d) ? CANONICAL_NAN : b);
+    }
+    static constexpr Value boolean(bool b) { return Value(QNAN | (b ? TAG_TRUE : TAG_FALSE)); }
+    static constexpr Value null() { return Value(QNAN | TAG_NULL); }
+    static Value object(RuntimeValue* object) { return Value(SIGN_BIT | QNAN | (uint64_t)(uintptr_t)object); }
+
+    // Oznaka za se nedeklarirano rezo v okolju, v jeziku ni dosegljiva
+    static constexpr Value empty() { return Value(QNAN | TAG_EMPTY); }
+
+    bool isNumber() const { return (this->bits & QNAN) != QNAN; }
+    bool isNull() const { return this->bits == (QNAN | TAG_NULL); }
+    bool isBool() const { return (this->bits | 1) == (QNAN | TAG_TRUE); }
+    bool isObject() const { return (this->bits & (SIGN_BIT | QNAN)) == (SIGN_BIT | QNAN); }
+    bool isEmpty() const { return this->bits == (QNAN | TAG_EMPTY); }
+
+    double asNumber() const {
+        double d;
+        std::memcpy(&d, &this->bits, sizeof(d));
+        return d;
+    }
+    bool asBool() const { return this->bits == (QNAN | TAG_TRUE); }
+    RuntimeValue* asObject() const { return (RuntimeValue*)(uintptr_t)(this->bits & ~(SIGN_BIT | QNAN)); }
+
+    // Ali je vrednost na kopici danega tipa
+    bool isObjectOf(ValueType t) const { return this->isObject() && this->asObject()->type == t; }
+
+    ValueType type() const {
+        if (this->isNumber()) {
+            return VALUETYPE_NUMBER;
+        }
+        if (this->isObject()) {
+            return this->asObject()->type;
+        }
+        return this->isBool() ? VALUETYPE_BOOLEAN : VALUETYPE_NULL;
+    }
+    std::string getTypeName() const { return ::getTypeName(this->type()); }
+
+    // Enakost bitov (istovetnost za vrednosti na kopici)
+    bool operator==(const Value& other) const { return this->bits == other.bits; }
+    bool operator!=(const Value& other) const { return this->bits != other.bits; }
 };
 
+static_assert(sizeof(Value) == 8, "Value must fit in 64 bits");
+
 class StringValue : public RuntimeValue {
   public:
     StringValue(std::string val = "");
     virtual ~StringValue();
     std::string value;
+
+    // Simbol interniranega niza ali NO_SYMBOL
+    // Za vsak simbol obstaja en sam interniran niz, zato sta dva internirana
+    // niza enaka natanko tedaj, ko sta isti objekt
+    Symbol symbol = NO_SYMBOL;
     void toString();
+
+    size_t extraSize() const override;
 };
 
+// Objekt hrani vrednosti lastnosti v zaporednih rezah, kljuce pa njegova oblika
+// Lastnosti se le dodajajo, nikoli odstranijo
 class ObjectValue : public RuntimeValue {
+  private:
+    static constexpr size_t INLINE_SLOTS = 4;
+
+    Shape* shape;
+    Value* slots;
+    uint32_t capacity;
+
+    // Reze majhnih objektov so v samem objektu, vecje v loceni tabeli
+    Value inlineSlots[INLINE_SLOTS];
+    std::unique_ptr<Value[]> overflowSlots;
+
   public:
     ObjectValue();
-    ObjectValue(std::map<std::string, RuntimeValue*> p);
+
+    // Objekt z vsemi lastnostmi oblike, nastavljenimi na null
+    ObjectValue(Shape* s);
     virtual ~ObjectValue();
-    std::map<std::string, RuntimeValue*> properties;
+
+    Shape* getShape() const { return this->shape; }
+    Value getSlot(uint32_t slot) const { return this->slots[slot]; }
+    void setSlot(uint32_t slot, Value value) { this->slots[slot] = value; }
+
+    // Kazalec na vrednost lastnosti ali nullptr, ce je objekt nima
+    Value* findProperty(Symbol key);
+
+    // Nastavi lastnost, manjkajoco doda s prehodom v novo obliko
+    void setProperty(Symbol key, Value value);
+
+    void trace(Heap& heap) override;
+    size_t extraSize() const override;
 };
 
-RuntimeValue* MK_NULL();
-RuntimeValue* MK_BOOL(bool b = true);
-RuntimeValue* MK_NUMBER(float n = 0.0);
-RuntimeValue* MK_STRING(std::string s);
-RuntimeValue* MK_OBJECT(std::map<std::string, RuntimeValue*> obj);
+inline Value MK_NULL() { return Value::null(); }
+inline Value MK_BOOL(bool b = true) { return Value::boolean(b); }
+inline Value MK_NUMBER(double n = 0.0) { return Value::number(n); }
+Value MK_STRING(std::string s);
+
+// Edini niz s simbolom, ustvari se ob prvi uporabi in zivi do konca izvajanja
+Value MK_INTERNED_STRING(Symbol symbol);
+
+// Ali sta niza enaka; internirana niza primerja le po istovetnosti
+bool stringsEqual(Value lhs, Value rhs);
+Value MK_OBJECT(std::map<std::string, Value> obj);
 
 #endif
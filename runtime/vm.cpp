@@ -0,0 +1,307 @@
+#include "vm.h"
+
+#include <cmath>
+
+// GCC and Clang support labels as values, which lets every handler jump
+// straight to the next one (threaded dispatch). Other compilers use a switch.
+#if defined(__GNUC__) || defined(__clang__)
+#define SLO_COMPUTED_GOTO 1
+#else
+#define SLO_COMPUTED_GOTO 0
+#endif
+
+/**
+ * Get the compiled body of a function, compiling it on the first call.
+ *
+ * @param func The function being called.
+ * @return The compiled body, or nullptr if the body cannot be compiled.
+ */
+Chunk* VM::chunkFor(FunctionValue* func) {
+    FunctionDeclaration* declaration = func->prototype->declaration;
+    if (declaration == nullptr || declaration->compileFailed) {
+        return nullptr;
+    }
+    if (!declaration->chunk) {
+        try {
+            declaration->chunk = Compiler().compileFunction(declaration);
+        } catch (const CompileError&) {
+            declaration->compileFailed = true;
+            return nullptr;
+        }
+    }
+    return declaration->chunk.get();
+}
+
+/**
+ * Run compiled code until the entry frame returns.
+ *
+ * @param entry The chunk to execute.
+ * @param env The environment the chunk runs in.
+ * @param arena The arena holding the AST the chunk was compiled from.
+ * @return The value returned by the entry chunk.
+ */
+Value VM::execute(Chunk* entry, Environment* env, const std::shared_ptr<AstArena>* arena) {
+    std::vector<Frame> frames;
+
+    Chunk* chunk = entry;
+    const Instruction* code = chunk->code.data();
+    const Instruction* ip = code;
+    const Instruction* instr = nullptr;
+    size_t base = 0;
+
+    if (this->registers.size() < (size_t)chunk->registerCount) {
+        this->registers.resize(chunk->registerCount);
+    }
+    Value* regs = this->registers.data() + base;
+
+    // The function running in the current frame. It owns the chunk and
+    // the arena, so it must stay alive even after a tail call overwrites
+    // the register that held it.
+    Value function = MK_NULL();
+
+    // Registers, the current environment and function, and the environments
+    // and functions of suspended frames are roots for the duration of the run
+    Root registersRoot(this->registers);
+    Root envRoot(env);
+    Root functionRoot(function);
+    Root framesRoot(&frames, [](void* pointer, Heap& heap) {
+        for (const Frame& frame : *static_cast<std::vector<Frame>*>(pointer)) {
+            heap.markEnvironment(frame.env);
+            heap.markValue(frame.function);
+        }
+    });
+
+#if SLO_COMPUTED_GOTO
+    static void* dispatchTable[] = {
+#define SLO_OPCODE_LABEL(name) &&L_##name,
+        SLO_OPCODES(SLO_OPCODE_LABEL)
+#undef SLO_OPCODE_LABEL
+    };
+#define VM_CASE(name) L_##name:
+#define VM_NEXT() do { instr = ip++; goto *dispatchTable[instr->op]; } while (0)
+    VM_NEXT();
+#else
+#define VM_CASE(name) case BC_##name:
+#define VM_NEXT() goto dispatch
+dispatch:
+    instr = ip++;
+    switch (instr->op) {
+#endif
+
+// Arithmetic and comparison on two numbers is done inline,
+// everything else goes through the interpreter's generic path
+#define VM_NUMERIC(name, oper, result)                                                          \
+    VM_CASE(name) {                                                                             \
+        Value lhs = regs[instr->b];                                                             \
+        Value rhs = regs[instr->c];                                                             \
+        if (lhs.isNumber() && rhs.isNumber()) {                                                 \
+            double l = lhs.asNumber();                                                          \
+            double r = rhs.asNumber();                                                          \
+            regs[instr->a] = (result);                                                          \
+        } else {                                                                                \
+            regs[instr->a] = evaluateNumericBinaryExpression(lhs, rhs, oper);                   \
+        }                                                                                       \
+        VM_NEXT();                                                                              \
+    }
+
+    VM_CASE(LOAD_CONST) {
+        regs[instr->a] = chunk->constants[instr->b];
+        VM_NEXT();
+    }
+    VM_CASE(LOAD_NULL) {
+        regs[instr->a] = MK_NULL();
+        VM_NEXT();
+    }
+    VM_CASE(GET_SLOT) {
+        regs[instr->a] = env->lookupSlot(instr->depth, instr->b, chunk->names[instr->c]);
+        VM_NEXT();
+    }
+    VM_CASE(SET_SLOT) {
+        env->assignSlot(instr->depth, instr->b, regs[instr->a], chunk->names[instr->c]);
+        VM_NEXT();
+    }
+    VM_CASE(DECLARE_SLOT) {
+        env->declareSlot(instr->b, regs[instr->a], chunk->names[instr->c]);
+        VM_NEXT();
+    }
+    VM_CASE(GET_NAME) {
+        regs[instr->a] = lookupNameCached(chunk->identifiers[instr->b], env);
+        VM_NEXT();
+    }
+    VM_CASE(SET_NAME) {
+        assignNameCached(chunk->identifiers[instr->b], env, regs[instr->a]);
+        VM_NEXT();
+    }
+    VM_CASE(DECLARE_NAME) {
+        env->declareVariable((Symbol)instr->c, regs[instr->a], instr->depth != 0);
+        VM_NEXT();
+    }
+    VM_CASE(DECLARE_FUNCTION) {
+        regs[instr->a] = declareFunction(chunk->functions[instr->b], env, *arena);
+        VM_NEXT();
+    }
+
+    VM_NUMERIC(ADD, OP_ADD, MK_NUMBER(l + r))
+    VM_NUMERIC(SUBTRACT, OP_SUBTRACT, MK_NUMBER(l - r))
+    VM_NUMERIC(MULTIPLY, OP_MULTIPLY, MK_NUMBER(l * r))
+    VM_NUMERIC(DIVIDE, OP_DIVIDE, (r == 0.0) ? evaluateNumericBinaryExpression(lhs, rhs, OP_DIVIDE) : MK_NUMBER(l / r))
+    VM_NUMERIC(MODULO, OP_MODULO, (r == 0.0) ? evaluateNumericBinaryExpression(lhs, rhs, OP_MODULO) : MK_NUMBER(std::fmod(l, r)))
+    VM_NUMERIC(EQUALS, OP_EQUALS, MK_BOOL(l == r))
+    VM_NUMERIC(NOT_EQUALS, OP_NOT_EQUALS, MK_BOOL(l != r))
+    VM_NUMERIC(LESS, OP_LESS, MK_BOOL(l < r))
+    VM_NUMERIC(GREATER, OP_GREATER, MK_BOOL(l > r))
+    VM_NUMERIC(LESS_EQUALS, OP_LESS_EQUALS, MK_BOOL(l <= r))
+    VM_NUMERIC(GREATER_EQUALS, OP_GREATER_EQUALS, MK_BOOL(l >= r))
+
+    VM_CASE(BRANCH) {
+        Value test = regs[instr->a];
+        if (!test.isBool()) {
+            ip = code + instr->c;
+        } else if (!test.asBool()) {
+            ip = code + instr->b;
+        }
+        VM_NEXT();
+    }
+    VM_CASE(JUMP) {
+        ip = code + instr->b;
+        VM_NEXT();
+    }
+    VM_CASE(ENTER_SCOPE) {
+        env = heap().allocate<Environment>(env, instr->b);
+        VM_NEXT();
+    }
+    VM_CASE(LEAVE_SCOPE) {
+        env = env->getParent();
+        VM_NEXT();
+    }
+    VM_CASE(CALL) {
+        Value callee = regs[instr->b];
+        Value* args = regs + instr->b + 1;
+
+        if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            FunctionValue* func = static_cast<FunctionValue*>(callee.asObject());
+            Chunk* target = this->chunkFor(func);
+            if (target == nullptr) {
+                regs[instr->a] = callFunction(func, args, instr->c);
+                VM_NEXT();
+            }
+
+            Environment* scope = bindArguments(func, args, instr->c);
+            frames.push_back({chunk, ip, env, base, instr->a, arena, function});
+
+            // The callee's registers start right after the caller's
+            base += chunk->registerCount;
+            if (this->registers.size() < base + target->registerCount) {
+                this->registers.resize(std::max(base + target->registerCount, this->registers.size() * 2));
+            }
+            regs = this->registers.data() + base;
+
+            chunk = target;
+            code = chunk->code.data();
+            ip = code;
+            env = scope;
+            arena = &func->prototype->arena;
+            function = callee;
+            VM_NEXT();
+        } else if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            NativeFunctionValue* fn = static_cast<NativeFunctionValue*>(callee.asObject());
+            regs[instr->a] = fn->call(ArgumentSpan(args, instr->c), env);
+            VM_NEXT();
+        }
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    }
+    VM_CASE(TAIL_CALL) {
+        Value callee = regs[instr->b];
+        Value* args = regs + instr->b + 1;
+
+        if (callee.isObjectOf(VALUETYPE_FUNCTION)) {
+            FunctionValue* func = static_cast<FunctionValue*>(callee.asObject());
+            Chunk* target = this->chunkFor(func);
+            if (target != nullptr) {
+                // The arguments are copied into the new scope before
+                // the callee starts overwriting the registers of this frame
+                env = bindArguments(func, args, instr->c);
+                if (this->registers.size() < base + target->registerCount) {
+                    this->registers.resize(std::max(base + target->registerCount, this->registers.size() * 2));
+                    regs = this->registers.data() + base;
+                }
+
+                chunk = target;
+                code = chunk->code.data();
+                ip = code;
+                arena = &func->prototype->arena;
+                function = callee;
+                VM_NEXT();
+            }
+            regs[instr->a] = callFunction(func, args, instr->c);
+            VM_NEXT();
+        } else if (callee.isObjectOf(VALUETYPE_NATIVE_FUNCTION)) {
+            // The result flows to the return of this frame like any other value
+            NativeFunctionValue* fn = static_cast<NativeFunctionValue*>(callee.asObject());
+            regs[instr->a] = fn->call(ArgumentSpan(args, instr->c), env);
+            VM_NEXT();
+        }
+        throw std::runtime_error("Cannot call a value that is not a function.");
+    }
+    VM_CASE(NEW_OBJECT) {
+        regs[instr->a] = Value::object(heap().allocate<ObjectValue>(chunk->shapes[instr->b]));
+        VM_NEXT();
+    }
+    VM_CASE(SET_PROPERTY) {
+        static_cast<ObjectValue*>(regs[instr->a].asObject())->setSlot(instr->c, regs[instr->b]);
+        VM_NEXT();
+    }
+    VM_CASE(GET_PROPERTY) {
+        regs[instr->a] = getPropertyCached(chunk->members[instr->c], regs[instr->b]);
+        VM_NEXT();
+    }
+    VM_CASE(GET_INDEX) {
+        regs[instr->a] = getProperty(regs[instr->b], computedPropertyKey(regs[instr->c]));
+        VM_NEXT();
+    }
+    VM_CASE(THROW) {
+        throw std::runtime_error(chunk->names[instr->c]);
+    }
+    VM_CASE(RETURN) {
+        Value result = regs[instr->a];
+        if (frames.empty()) {
+            return result;
+        }
+
+        Frame& caller = frames.back();
+        chunk = caller.chunk;
+        code = chunk->code.data();
+        ip = caller.ip;
+        env = caller.env;
+        base = caller.base;
+        arena = caller.arena;
+        function = caller.function;
+        regs = this->registers.data() + base;
+        regs[caller.returnRegister] = result;
+        frames.pop_back();
+        VM_NEXT();
+    }
+
+#if !SLO_COMPUTED_GOTO
+    default:
+        break;
+    }
+#endif
+
+#undef VM_NUMERIC
+#undef VM_CASE
+#undef VM_NEXT
+
+    throw std::runtime_error("Invalid bytecode instruction.");
+}
+
+Value VM::run(Program& program, Environment* env) {
+    std::unique_ptr<Chunk> chunk;
+    try {
+        chunk = Compiler().compileProgram(program);
+    } catch (const CompileError& error) {
+        std::cerr << error.what() << " Falling back to the tree-walking interpreter." << std::endl;
+        return evaluate(&program, env);
+    }
+    return this->execute(chunk.get(), env, &program.arena);
+}
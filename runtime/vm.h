@@ -0,0 +1,41 @@
+#ifndef VM_H
+#define VM_H
+
+#include "compiler.h"
+#include "interpreter.h"
+
+// Registrski navidezni stroj
+// Klici uporabniskih funkcij ne rekurzirajo v C++, ampak
+// dodajo okvir na sklad okvirjev znotraj iste zanke
+
+class VM {
+  private:
+    // Okvir klica funkcije
+    struct Frame {
+        Chunk* chunk;
+        const Instruction* ip;
+        Environment* env;
+        size_t base;
+        uint16_t returnRegister;
+        const std::shared_ptr<AstArena>* arena;
+
+        // Funkcija, ki se izvaja v okvirju (null za program)
+        Value function;
+    };
+
+    // Registri vseh aktivnih okvirjev
+    std::vector<Value> registers = {};
+
+    // Prevedi telo funkcije ob prvem klicu
+    // Vrne nullptr, ce telesa ni mogoce prevesti
+    Chunk* chunkFor(FunctionValue* func);
+
+    Value execute(Chunk* chunk, Environment* env, const std::shared_ptr<AstArena>* arena);
+
+  public:
+    // Izvedi program v danem okolju
+    // Ce programa ni mogoce prevesti, ga izvede drevesni interpreter
+    Value run(Program& program, Environment* env);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#!/bin/bash
+# Prevajanje v C++ (user-025): primerjava izpisov z interpreterjem
+#
+#     tests/aot.sh [slo++]
+#
+# Vsak program v tests/aot/ se prevede z slo++ --emit-cpp in g++ -O2 ter
+# poveze z izvajalnikom, ki se prevede enkrat za vse programe. Izpis
+# prevedenega programa se mora ujemati z izpisom drevesnega interpreterja.
+source "$(dirname "$0")/lib.sh"
+slopp_init "$1"
+
+mkdir -p "$work/obj"
+for source in "$root"/frontend/*.cpp "$root"/runtime/*.cpp; do
+    echo "$source"
+done | xargs -P "$(nproc)" -I{} sh -c 'g++ -std=c++17 -O2 -c "$1" -o "$2/$(basename "$1" .cpp).o"' _ {} "$work/obj" || exit 1
+
+for file in "$root"/tests/aot/*.slo; do
+    name="$(basename "$file" .slo)"
+    if ! "$slopp" --emit-cpp "$file" > "$work/$name.cpp" 2> "$work/$name.err"; then
+        fail "$name.slo: --emit-cpp: $(cat "$work/$name.err")"
+        continue
+    fi
+    if ! g++ -std=c++17 -O2 -I"$root" "$work/$name.cpp" "$work"/obj/*.o -o "$work/$name" 2> "$work/$name.err"; then
+        fail "$name.slo: g++: $(head -n 3 "$work/$name.err")"
+        continue
+    fi
+    expected="$(slopp_run --no-tier "$file")"
+    output="$("$work/$name" </dev/null 2>&1)"
+    if [ "$output" = "$expected" ]; then
+        pass "$name.slo"
+    else
+        fail "$name.slo"
+        diff <(echo "$expected") <(echo "$output") | head -n 10
+    fi
+done
+finish
@@ -0,0 +1,39 @@
+#!/bin/bash
+# Strojna koda (user-024): primerjava izpisov z drevesnim interpreterjem
+#
+#     tests/jit.sh [slo++]
+#
+# Vsak program v tests/jit/ se izvede z --no-tier in s prevajanjem ob prvem
+# klicu (--jit in --jit-verify s --tier-threshold=1). Izpisa, vkljucno z
+# napakami, se morata ujemati. Programi pokrivajo deljenje z 0, izstop ob
+# pregloboki rekurziji, ciste vgrajene funkcije in opustitev strojne kode
+# po 16 izstopih, ki jo preveri se statistika (--stats).
+source "$(dirname "$0")/lib.sh"
+
+if [ "$(uname -s)" != "Linux" ] || [ "$(uname -m)" != "x86_64" ]; then
+    echo "strojna koda je podprta le na x86-64 Linux, test je preskocen"
+    exit 0
+fi
+slopp_init "$1"
+
+for file in "$root"/tests/jit/*.slo; do
+    name="$(basename "$file")"
+    expected="$(slopp_run --no-tier "$file")"
+    for engine in "--jit" "--jit-verify"; do
+        output="$(slopp_run $engine --tier-threshold=1 "$file")"
+        if [ "$output" = "$expected" ]; then
+            pass "$name $engine"
+        else
+            fail "$name $engine"
+            diff <(echo "$expected") <(echo "$output") | head -n 10
+        fi
+    done
+done
+
+stats="$(slopp_run --jit --tier-threshold=1 --stats "$root/tests/jit/odpoved.slo" | grep "Strojna koda")"
+if echo "$stats" | grep -q " 16 izstopov"; then
+    pass "odpoved.slo opustitev po 16 izstopih"
+else
+    fail "odpoved.slo opustitev po 16 izstopih: $stats"
+fi
+finish
@@ -0,0 +1,40 @@
+# Skupno za teste: pot do slo++ in primerjava izpisov
+#
+#     source tests/lib.sh; slopp_init "$@"
+#
+# Brez poti do slo++ v prvem argumentu se interpreter prevede z g++ -O2
+# v zacasno mapo $work, ki se ob izhodu izbrise.
+
+root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+failures=0
+
+slopp_init() {
+    work="$(mktemp -d)"
+    trap 'rm -rf "$work"' EXIT
+    if [ -n "$1" ] && [ -x "$1" ]; then
+        slopp="$1"
+    else
+        slopp="$work/slo++"
+        g++ -std=c++17 -O2 -o "$slopp" "$root"/main.cpp "$root"/frontend/*.cpp "$root"/runtime/*.cpp || exit 1
+    fi
+}
+
+# Izpis slo++ s standardnim izhodom in napakami; vhod je prazen (ENTER ob koncu)
+slopp_run() {
+    "$slopp" "$@" </dev/null 2>&1
+}
+
+pass() {
+    echo "ok   $*"
+}
+
+fail() {
+    echo "FAIL $*"
+    failures=$((failures + 1))
+}
+
+# Konec testa: izpise stevilo neuspelih primerov, izhodna koda je 1, ce kateri ne uspe
+finish() {
+    echo "$failures neuspelih"
+    exit $((failures > 0))
+}
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Klici v repnem polozaju (user-011): stevec do 10 milijonov v konstantnem pomnilniku
+#
+#     tests/tail.sh [slo++]
+#
+# Vsak pogon mora program izvesti s kopico, omejeno na 4 MB, in z navideznim
+# pomnilnikom procesa, omejenim na 512 MB; rekurzija ali rast kopice pri
+# vsakem klicu bi eno od omejitev presegla.
+source "$(dirname "$0")/lib.sh"
+slopp_init "$1"
+
+expected="$(printf 'SLO++ v0.1\n1e+07\nProgram se je koncal. Pritisnite tipko ENTER za izhod...Nasvidenje')"
+for engine in "--no-tier" "" "--closure" "--stack" "--vm" "--jit --tier-threshold=1"; do
+    output="$(ulimit -v 524288; slopp_run $engine --heap-limit=4 "$root/tests/tail/stevec.slo")"
+    if [ "$output" = "$expected" ]; then
+        pass "stevec.slo ${engine:-(privzeto)}"
+    else
+        fail "stevec.slo ${engine:-(privzeto)}: $(echo "$output" | tail -n 2)"
+    fi
+done
+finish